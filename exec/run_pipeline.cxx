@@ -0,0 +1,511 @@
+/**
+ * @file run_pipeline.cxx
+ *
+ * Runs a TP -> TA -> TC -> TD chain of triggeralgs makers, one thread per stage, connected
+ * by SPSC rings, and reports per-stage throughput, queue depths and end-to-end latency.
+ *
+ * Usage: run_pipeline [-c config.json] [-n n_tps] [-w spin|yield|park] [-q queue_capacity]
+ *                     [-o capture.tpc]
+ *
+ * The optional config file picks the makers:
+ *   { "activity_maker": "TriggerActivityMakerPrescalePlugin", "activity_config": {...},
+ *     "candidate_maker": "...", "candidate_config": {...},
+ *     "decision_maker": "...", "decision_config": {...} }
+ * With "fused": true the TA and TC makers share one thread as a FusedCandidateMaker (the
+ * "FusedCandidateMakerPlugin" pipeline), and "pipeline": "<name>" replaces both with a pipeline
+ * from the CandidatePipelineFactory, eg "HorizontalMuonPipeline" (configured from
+ * activity_config and candidate_config).
+ * A LoadSheddingActivityMakerPlugin TA maker is given the depth of the TP queue as its backlog.
+ * "affinity": { "source": [cores], "activity": [...], "candidate": [...], "decision": [...] }
+ * pins each thread to the listed CPU cores. "metrics": true turns on the makers' counters and
+ * prints their get_metrics() at the end.
+ * -o records the generated TPs as a TPCapture file.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/Affinity.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/CandidatePipelineFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/LoadSheddingActivityMaker.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/SPSCRing.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPCapture.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerDecisionFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/WaitStrategy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace triggeralgs;
+
+using steady_clock = std::chrono::steady_clock;
+
+namespace {
+
+int64_t
+now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/// An object in flight, with the wall-clock time its originating TP entered the pipeline.
+template<typename T>
+struct Stamped
+{
+  T obj;
+  int64_t ingest_ns = 0;
+};
+
+template<typename T>
+class Queue
+{
+public:
+  Queue(const std::string& name, size_t capacity, WaitMode mode)
+    : m_name(name)
+    , m_ring(capacity)
+    , m_not_empty(mode)
+    , m_not_full(mode)
+  {}
+
+  void push(Stamped<T>&& item)
+  {
+    while (!m_ring.try_push(std::move(item)))
+      m_not_full.wait();
+    m_not_full.reset();
+    m_not_empty.notify();
+  }
+
+  /// @brief Returns false once the queue is closed and drained
+  bool pop(Stamped<T>& item)
+  {
+    while (!m_ring.try_pop(item)) {
+      if (m_closed.load(std::memory_order_acquire))
+        return m_ring.try_pop(item);
+      m_not_empty.wait();
+    }
+    m_not_empty.reset();
+    m_not_full.notify();
+    return true;
+  }
+
+  void close()
+  {
+    m_closed.store(true, std::memory_order_release);
+    m_not_empty.notify();
+  }
+
+  size_t size() const { return m_ring.size(); }
+
+  void sample_depth()
+  {
+    size_t depth = m_ring.size();
+    m_depth_max = std::max(m_depth_max, depth);
+    m_depth_sum += depth;
+    m_n_samples++;
+  }
+
+  void report() const
+  {
+    std::cout << "  " << std::setw(6) << m_name << " capacity " << m_ring.capacity() << ", mean depth "
+              << (m_n_samples ? static_cast<double>(m_depth_sum) / m_n_samples : 0.) << ", max depth " << m_depth_max
+              << "\n";
+  }
+
+private:
+  std::string m_name;
+  SPSCRing<Stamped<T>> m_ring;
+  WaitStrategy m_not_empty; // Consumer waits here
+  WaitStrategy m_not_full;  // Producer waits here
+  std::atomic<bool> m_closed{ false };
+
+  // Only touched by the monitoring thread.
+  size_t m_depth_max = 0;
+  size_t m_depth_sum = 0;
+  size_t m_n_samples = 0;
+};
+
+struct StageStats
+{
+  std::string name;
+  uint64_t n_in = 0;
+  uint64_t n_out = 0;
+  double seconds = 0;
+
+  void report() const
+  {
+    std::cout << "  " << std::setw(6) << name << " " << n_in << " in, " << n_out << " out, "
+              << (seconds > 0 ? n_in / seconds / 1e6 : 0.) << " M inputs/s\n";
+  }
+};
+
+/// @brief Pops inputs until the input queue closes, runs them through `process`, which pushes
+/// everything it makes straight onto the output queue through a sink, then calls `flush` and
+/// closes the output queue.
+template<typename In, typename Out, typename Process, typename Flush>
+void
+run_stage(Queue<In>& input, Queue<Out>& output, Process&& process, Flush&& flush, StageStats& stats)
+{
+  Stamped<In> item;
+  int64_t ingest_ns = 0;
+  auto sink = make_callback_sink<Out>([&](Out&& obj) {
+    output.push({ std::move(obj), ingest_ns });
+    stats.n_out++;
+  });
+  auto start = steady_clock::now();
+
+  while (input.pop(item)) {
+    stats.n_in++;
+    ingest_ns = item.ingest_ns;
+    process(item.obj, sink);
+  }
+
+  // Whatever is flushed is stamped with the last input.
+  flush(sink);
+
+  stats.seconds = std::chrono::duration<double>(steady_clock::now() - start).count();
+  output.close();
+}
+
+/// @brief Gives `tc` the TAs its input_refs point to in `maker`'s store, and says so if some
+/// were already overwritten. The maker counts those TCs as drops.
+template<typename Maker>
+void
+resolve_or_report(Maker& maker, TriggerCandidate& tc)
+{
+  if (!maker.resolve(tc))
+    std::cerr << "TC at " << tc.time_candidate << " lost TAs that were overwritten in the store\n";
+}
+
+/// @brief Has `tc_maker` emit TCs into `out` through `make`, first resolving their input_refs
+/// if it keeps a store. TCs leave their stage here, and the store doesn't go with them.
+template<typename Make>
+void
+make_resolved(TriggerCandidateMaker& tc_maker, OutputSink<TriggerCandidate>& out, Make&& make)
+{
+  if (!tc_maker.get_activity_store()) {
+    make(out);
+    return;
+  }
+  auto resolving = make_callback_sink<TriggerCandidate>([&](TriggerCandidate&& tc) {
+    resolve_or_report(tc_maker, tc);
+    out.emit(std::move(tc));
+  });
+  make(resolving);
+}
+
+/// Clusters of TPs on adjacent channels on top of uniform noise, in time order.
+std::vector<TriggerPrimitive>
+generate_tps(size_t n_tps)
+{
+  std::default_random_engine generator(12345);
+  std::uniform_int_distribution<channel_t> rdm_channel(0, 2560);
+  std::normal_distribution<double> rdm_adc(2000, 500);
+  std::normal_distribution<double> rdm_time_over_threshold(20, 4);
+  std::exponential_distribution<double> rdm_gap(1. / 4);
+  std::bernoulli_distribution rdm_cluster(0.01);
+
+  std::vector<TriggerPrimitive> tps;
+  tps.reserve(n_tps);
+  timestamp_t time = 0;
+  channel_t cluster_channel = 0;
+  size_t cluster_left = 0;
+
+  while (tps.size() < n_tps) {
+    TriggerPrimitive tp{};
+    time += static_cast<timestamp_t>(rdm_gap(generator));
+    if (cluster_left == 0 && rdm_cluster(generator)) {
+      cluster_left = 20;
+      cluster_channel = rdm_channel(generator);
+    }
+    if (cluster_left > 0) {
+      tp.channel = cluster_channel++;
+      cluster_left--;
+    } else {
+      tp.channel = rdm_channel(generator);
+    }
+    tp.time_start = time;
+    tp.time_over_threshold = std::max(1., rdm_time_over_threshold(generator));
+    tp.time_peak = time + tp.time_over_threshold / 2;
+    tp.adc_integral = std::max(0., rdm_adc(generator));
+    tp.adc_peak = tp.adc_integral / 10;
+    tps.push_back(tp);
+  }
+  return tps;
+}
+
+void
+usage()
+{
+  std::cerr << "Usage: run_pipeline [-c config.json] [-n n_tps] [-w spin|yield|park] [-q queue_capacity]"
+               " [-o capture.tpc]\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string config_path;
+  std::string capture_path;
+  size_t n_tps = 1000000;
+  size_t queue_capacity = 1024;
+  WaitMode wait_mode = WaitMode::kYield;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (arg == "-c") {
+      config_path = value;
+    } else if (arg == "-n") {
+      n_tps = std::stoul(value);
+    } else if (arg == "-o") {
+      capture_path = value;
+    } else if (arg == "-q") {
+      queue_capacity = std::stoul(value);
+    } else if (arg == "-w" && parse_wait_mode(value, wait_mode)) {
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  nlohmann::json config = nlohmann::json::object();
+  if (!config_path.empty()) {
+    std::ifstream config_file(config_path);
+    if (!config_file) {
+      std::cerr << "Can't open " << config_path << "\n";
+      return 1;
+    }
+    config_file >> config;
+  }
+  std::string ta_name = config.value("activity_maker", "TriggerActivityMakerPrescalePlugin");
+  std::string tc_name = config.value("candidate_maker", "TriggerCandidateMakerPrescalePlugin");
+  std::string td_name = config.value("decision_maker", "TriggerDecisionMakerCoalescingPlugin");
+
+  auto ta_maker = TriggerActivityFactory::get_instance()->build_maker(ta_name);
+  auto tc_maker = TriggerCandidateFactory::get_instance()->build_maker(tc_name);
+  auto td_maker = TriggerDecisionFactory::get_instance()->build_maker(td_name);
+  if (!ta_maker || !tc_maker || !td_maker) {
+    std::cerr << "Couldn't build " << ta_name << " / " << tc_name << " / " << td_name << "\n";
+    return 1;
+  }
+  ta_maker->configure(config.value("activity_config", nlohmann::json::object()));
+  tc_maker->configure(config.value("candidate_config", nlohmann::json::object()));
+  td_maker->configure(config.value("decision_config", nlohmann::json::object()));
+
+  nlohmann::json affinity = config.value("affinity", nlohmann::json::object());
+  auto pin = [&](const std::string& thread_name) {
+    if (affinity.contains(thread_name) && !pin_current_thread(affinity[thread_name].get<std::vector<int>>()))
+      std::cerr << "Couldn't set the CPU affinity of the " << thread_name << " thread\n";
+  };
+
+  auto* shedder = dynamic_cast<LoadSheddingActivityMaker*>(ta_maker.get());
+
+  std::string pipeline_name = config.value("pipeline", config.value("fused", false) ? "FusedCandidateMakerPlugin" : "");
+  bool fused = !pipeline_name.empty();
+  std::unique_ptr<CandidatePipeline> pipeline;
+  if (fused) {
+    pipeline = CandidatePipelineFactory::get_instance()->build_maker(pipeline_name);
+    if (!pipeline) {
+      std::cerr << "Couldn't build " << pipeline_name << "\n";
+      return 1;
+    }
+    nlohmann::json pipeline_config = config;
+    pipeline_config["activity_maker"] = ta_name;
+    pipeline_config["candidate_maker"] = tc_name;
+    pipeline->configure(pipeline_config);
+  }
+
+  bool metrics = config.value("metrics", false);
+  if (metrics) {
+    ta_maker->enable_metrics();
+    tc_maker->enable_metrics();
+    td_maker->enable_metrics();
+    if (pipeline)
+      pipeline->enable_metrics();
+  }
+
+  // Generate everything up front, so the source isn't the bottleneck.
+  std::vector<TriggerPrimitive> tps = generate_tps(n_tps);
+  if (!capture_path.empty()) {
+    TPCaptureWriter capture;
+    if (capture.open(capture_path))
+      for (const auto& tp : tps)
+        capture.write(tp);
+    if (!capture.close() || !capture.is_good()) {
+      std::cerr << "Couldn't write " << capture_path << "\n";
+      return 1;
+    }
+  }
+
+  Queue<TriggerPrimitive> tp_queue("TP", queue_capacity, wait_mode);
+  Queue<TriggerActivity> ta_queue("TA", queue_capacity, wait_mode);
+  Queue<TriggerCandidate> tc_queue("TC", queue_capacity, wait_mode);
+  StageStats ta_stats{ fused ? "TA+TC" : "TAM" }, tc_stats{ "TCM" }, td_stats{ "TDM" };
+
+  std::atomic<bool> done{ false };
+  uint64_t n_tds = 0;
+  int64_t latency_sum_ns = 0;
+  int64_t latency_max_ns = 0;
+  auto start = steady_clock::now();
+
+  std::thread source([&]() {
+    pin("source");
+    for (auto& tp : tps)
+      tp_queue.push({ tp, now_ns() });
+    tp_queue.close();
+  });
+
+  std::thread ta_thread, tc_thread;
+  if (fused) {
+    ta_thread = std::thread([&]() {
+      pin("activity");
+      // Pipelines only fill vectors, so pass their TCs on from one that keeps its capacity.
+      std::vector<TriggerCandidate> made;
+      auto pass_on = [&](OutputSink<TriggerCandidate>& out) {
+        for (auto& tc : made) {
+          resolve_or_report(*pipeline, tc);
+          out.emit(std::move(tc));
+        }
+        made.clear();
+      };
+      run_stage(
+        tp_queue,
+        tc_queue,
+        [&](const TriggerPrimitive& tp, OutputSink<TriggerCandidate>& out) {
+          (*pipeline)(tp, made);
+          pass_on(out);
+        },
+        // Nothing follows the last TP, so the TC maker can be flushed all the way too.
+        [&](OutputSink<TriggerCandidate>& out) {
+          pipeline->flush(std::numeric_limits<timestamp_t>::max(), made);
+          pass_on(out);
+        },
+        ta_stats);
+    });
+  } else {
+    ta_thread = std::thread([&]() {
+      pin("activity");
+      run_stage(
+        tp_queue,
+        ta_queue,
+        [&](const TriggerPrimitive& tp, OutputSink<TriggerActivity>& out) {
+          if (shedder)
+            shedder->set_backlog(tp_queue.size());
+          (*ta_maker)(tp, out);
+        },
+        // Nothing follows the last TP, so flush the TA maker all the way.
+        [&](OutputSink<TriggerActivity>& out) { ta_maker->flush(std::numeric_limits<timestamp_t>::max(), out); },
+        ta_stats);
+    });
+
+    tc_thread = std::thread([&]() {
+      pin("candidate");
+      run_stage(
+        ta_queue,
+        tc_queue,
+        // The popped TA isn't needed again, so the TC maker can take it.
+        [&](TriggerActivity& ta, OutputSink<TriggerCandidate>& out) {
+          make_resolved(*tc_maker, out, [&](OutputSink<TriggerCandidate>& sink) { (*tc_maker)(std::move(ta), sink); });
+        },
+        [&](OutputSink<TriggerCandidate>& out) {
+          make_resolved(*tc_maker, out, [&](OutputSink<TriggerCandidate>& sink) {
+            tc_maker->flush(std::numeric_limits<timestamp_t>::max(), sink);
+          });
+        },
+        tc_stats);
+    });
+  }
+
+  std::thread td_thread([&]() {
+    pin("decision");
+    Stamped<TriggerCandidate> item;
+    std::vector<TriggerDecision> made;
+    int64_t last_ingest_ns = 0;
+    auto stage_start = steady_clock::now();
+
+    auto record = [&](int64_t ingest_ns) {
+      int64_t latency = now_ns() - ingest_ns;
+      latency_sum_ns += latency * static_cast<int64_t>(made.size());
+      latency_max_ns = std::max(latency_max_ns, latency);
+      td_stats.n_out += made.size();
+      n_tds += made.size();
+      made.clear();
+    };
+
+    while (tc_queue.pop(item)) {
+      td_stats.n_in++;
+      last_ingest_ns = item.ingest_ns;
+      (*td_maker)(item.obj, made);
+      if (!made.empty())
+        record(item.ingest_ns);
+    }
+    td_maker->flush(made);
+    if (!made.empty())
+      record(last_ingest_ns);
+
+    td_stats.seconds = std::chrono::duration<double>(steady_clock::now() - stage_start).count();
+    done = true;
+  });
+
+  while (!done) {
+    tp_queue.sample_depth();
+    ta_queue.sample_depth();
+    tc_queue.sample_depth();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  source.join();
+  ta_thread.join();
+  if (tc_thread.joinable())
+    tc_thread.join();
+  td_thread.join();
+  double seconds = std::chrono::duration<double>(steady_clock::now() - start).count();
+
+  std::cout << "Pipeline " << (fused ? pipeline_name : ta_name + " -> " + tc_name) << " -> " << td_name << "\n";
+  std::cout << "  " << n_tps << " TPs in " << seconds << " s: " << n_tps / seconds / 1e6 << " M TPs/s, "
+            << (fused ? pipeline->get_n_activities() : ta_stats.n_out) << " TAs, "
+            << (fused ? ta_stats.n_out : tc_stats.n_out) << " TCs, " << n_tds << " TDs\n";
+  std::cout << "Stages:\n";
+  ta_stats.report();
+  if (!fused)
+    tc_stats.report();
+  td_stats.report();
+  std::cout << "Queues:\n";
+  tp_queue.report();
+  if (!fused)
+    ta_queue.report();
+  tc_queue.report();
+  std::cout << "TP to TD latency: mean "
+            << (td_stats.n_out ? static_cast<double>(latency_sum_ns) / 1e3 / td_stats.n_out : 0.) << " us, max "
+            << latency_max_ns / 1e3 << " us\n";
+  if (metrics) {
+    nlohmann::json maker_metrics = { { "decision", td_maker->get_metrics() } };
+    if (fused) {
+      maker_metrics.update(pipeline->get_metrics());
+    } else {
+      maker_metrics["activity"] = ta_maker->get_metrics();
+      maker_metrics["candidate"] = tc_maker->get_metrics();
+    }
+    std::cout << "Maker metrics:\n" << maker_metrics.dump(2) << "\n";
+  }
+
+  return 0;
+}
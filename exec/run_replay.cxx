@@ -0,0 +1,279 @@
+/**
+ * @file run_replay.cxx
+ *
+ * Replays a TP capture (see TPCapture.hpp) through a TA maker and optionally a TC maker, at
+ * full speed or paced by the TPs' time_start, and reports throughput, output counts and how
+ * far processing fell behind data time.
+ *
+ * Usage: run_replay -i capture.tpc [-c config.json] [-r max|<speed>] [-s start_time] [-a warmup_tps]
+ *
+ * The optional config file picks the makers:
+ *   { "activity_maker": "TriggerActivityMakerHorizontalMuonPlugin", "activity_config": {...},
+ *     "candidate_maker": "...", "candidate_config": {...}, "clock_frequency_hz": 62.5e6 }
+ * With no candidate_maker only TAs are made. "metrics": true prints the makers' get_metrics().
+ * -r 1 replays in real time, -r 10 ten times faster than real time, and -r max (the default)
+ * as fast as the makers go. -s starts from the block holding start_time.
+ *
+ * -a reports the heap allocations (count and bytes) each maker makes per input after the first
+ * warmup_tps TPs, when the library is built with TRIGGERALGS_COUNT_ALLOCATIONS. With
+ *   "allocation_budget": { "activity": 0, "candidate": 0.5 }
+ * in the config it also fails, with exit status 2, if a maker makes more allocations per input
+ * than its budget: 0 holds a maker to being allocation-free once warmed up.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/AllocationCounter.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPCapture.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateFactory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace triggeralgs;
+
+using steady_clock = std::chrono::steady_clock;
+
+namespace {
+
+int64_t
+now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/// Sleeping overshoots by tens of us, so only sleep until just before `ns` and spin the rest.
+void
+wait_until(int64_t ns)
+{
+  const int64_t spin_ns = 100000;
+  int64_t now = now_ns();
+  if (ns - now > spin_ns)
+    std::this_thread::sleep_for(std::chrono::nanoseconds(ns - now - spin_ns));
+  while (now_ns() < ns) {
+  }
+}
+
+void
+usage()
+{
+  std::cerr << "Usage: run_replay -i capture.tpc [-c config.json] [-r max|<speed>] [-s start_time] [-a warmup_tps]\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string capture_path;
+  std::string config_path;
+  double speed = 0; // Multiple of real time, or 0 for as fast as possible
+  timestamp_t start_time = 0;
+  bool report_allocations = false;
+  uint64_t warmup_tps = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      usage();
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (arg == "-i") {
+      capture_path = value;
+    } else if (arg == "-c") {
+      config_path = value;
+    } else if (arg == "-r") {
+      speed = value == "max" ? 0 : std::stod(value);
+    } else if (arg == "-s") {
+      start_time = std::stoull(value);
+    } else if (arg == "-a") {
+      report_allocations = true;
+      warmup_tps = std::stoull(value);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+  if (capture_path.empty() || speed < 0) {
+    usage();
+    return 1;
+  }
+
+  nlohmann::json config = nlohmann::json::object();
+  if (!config_path.empty()) {
+    std::ifstream config_file(config_path);
+    if (!config_file) {
+      std::cerr << "Can't open " << config_path << "\n";
+      return 1;
+    }
+    config_file >> config;
+  }
+  std::string ta_name = config.value("activity_maker", "TriggerActivityMakerPrescalePlugin");
+  std::string tc_name = config.value("candidate_maker", "");
+  double clock_frequency_hz = config.value("clock_frequency_hz", 62.5e6);
+
+  auto ta_maker = TriggerActivityFactory::get_instance()->build_maker(ta_name);
+  std::unique_ptr<TriggerCandidateMaker> tc_maker;
+  if (!tc_name.empty())
+    tc_maker = TriggerCandidateFactory::get_instance()->build_maker(tc_name);
+  if (!ta_maker || (!tc_name.empty() && !tc_maker)) {
+    std::cerr << "Couldn't build " << ta_name << (tc_name.empty() ? "" : " / " + tc_name) << "\n";
+    return 1;
+  }
+  ta_maker->configure(config.value("activity_config", nlohmann::json::object()));
+  if (tc_maker)
+    tc_maker->configure(config.value("candidate_config", nlohmann::json::object()));
+  bool metrics = config.value("metrics", false);
+  if (metrics) {
+    ta_maker->enable_metrics();
+    if (tc_maker)
+      tc_maker->enable_metrics();
+  }
+
+  nlohmann::json allocation_budget = config.value("allocation_budget", nlohmann::json::object());
+  if ((report_allocations || !allocation_budget.empty()) && !allocation_counting_enabled()) {
+    std::cerr << "Can't count allocations: triggeralgs was built without TRIGGERALGS_COUNT_ALLOCATIONS\n";
+    return 1;
+  }
+
+  TPCaptureReader reader;
+  if (!reader.open(capture_path)) {
+    std::cerr << "Can't read " << capture_path << "\n";
+    return 1;
+  }
+
+  std::vector<TriggerPrimitive> tps;
+  std::vector<TriggerActivity> tas;
+  std::vector<TriggerCandidate> tcs;
+  uint64_t n_tps = 0, n_tas = 0, n_tcs = 0;
+  timestamp_t data_start = 0, data_end = 0;
+  bool started = false;
+  int64_t lag_max_ns = 0;
+  double lag_sum_ns = 0;
+  // Wall time per tick of data time, at the requested speed.
+  double ns_per_tick = speed > 0 ? 1e9 / clock_frequency_hz / speed : 0;
+
+  // TCs leave here, so give them their TAs while the store still has them.
+  auto resolve_candidates = [&]() {
+    for (auto& tc : tcs)
+      if (!tc_maker->resolve(tc))
+        std::cerr << "TC at " << tc.time_candidate << " lost TAs that were overwritten in the store\n";
+    n_tcs += tcs.size();
+    tcs.clear();
+  };
+  // What the makers allocate once warmed up, and for how many inputs.
+  AllocationCounts ta_allocations, tc_allocations;
+  uint64_t n_steady_tps = 0, n_steady_tas = 0;
+  auto make_activities = [&](const TriggerPrimitive& tp) {
+    AllocationScope allocations;
+    (*ta_maker)(tp, tas);
+    if (n_tps >= warmup_tps) {
+      ta_allocations += allocations.get();
+      n_steady_tps++;
+    }
+  };
+  auto make_candidates = [&]() {
+    n_tas += tas.size();
+    if (tc_maker) {
+      for (auto& ta : tas) {
+        AllocationScope allocations;
+        (*tc_maker)(std::move(ta), tcs);
+        if (n_tps >= warmup_tps) {
+          tc_allocations += allocations.get();
+          n_steady_tas++;
+        }
+      }
+      resolve_candidates();
+    }
+    tas.clear();
+  };
+
+  int64_t wall_start_ns = now_ns();
+  size_t block = reader.find_block(start_time);
+  for (; reader.read_block(block, tps); ++block) {
+    for (const auto& tp : tps) {
+      if (tp.time_start < start_time)
+        continue;
+      if (!started) {
+        started = true;
+        data_start = tp.time_start;
+        wall_start_ns = now_ns();
+      }
+      data_end = std::max(data_end, tp.time_start);
+
+      if (ns_per_tick > 0) {
+        // Wait for the TP's time to come round, and see how late it is when it's done.
+        int64_t due_ns = wall_start_ns + static_cast<int64_t>((tp.time_start - data_start) * ns_per_tick);
+        wait_until(due_ns);
+        make_activities(tp);
+        int64_t lag_ns = std::max<int64_t>(now_ns() - due_ns, 0);
+        lag_max_ns = std::max(lag_max_ns, lag_ns);
+        lag_sum_ns += lag_ns;
+      } else {
+        make_activities(tp);
+      }
+      n_tps++;
+      if (!tas.empty())
+        make_candidates();
+    }
+  }
+  if (block < reader.get_n_blocks())
+    std::cerr << "Stopped at corrupt block " << block << " of " << reader.get_n_blocks() << "\n";
+
+  // Nothing follows the last TP, so flush everything still held, whatever its window.
+  ta_maker->flush(std::numeric_limits<timestamp_t>::max(), tas);
+  make_candidates();
+  if (tc_maker) {
+    tc_maker->flush(std::numeric_limits<timestamp_t>::max(), tcs);
+    resolve_candidates();
+  }
+  double seconds = (now_ns() - wall_start_ns) / 1e9;
+  double data_seconds = started ? (data_end - data_start) / clock_frequency_hz : 0;
+
+  std::cout << "Replay of " << capture_path << " through " << ta_name << (tc_maker ? " -> " + tc_name : "") << "\n";
+  std::cout << "  " << n_tps << " TPs in " << seconds << " s: " << (seconds > 0 ? n_tps / seconds / 1e6 : 0.)
+            << " M TPs/s, " << n_tas << " TAs, " << n_tcs << " TCs\n";
+  std::cout << "  " << data_seconds << " s of data, " << (seconds > 0 ? data_seconds / seconds : 0.)
+            << "x real time\n";
+  if (ns_per_tick > 0)
+    std::cout << "  Lag behind data time at " << speed << "x: mean " << (n_tps ? lag_sum_ns / n_tps / 1e3 : 0.)
+              << " us, max " << lag_max_ns / 1e3 << " us\n";
+  if (metrics) {
+    nlohmann::json maker_metrics = { { "activity", ta_maker->get_metrics() } };
+    if (tc_maker)
+      maker_metrics["candidate"] = tc_maker->get_metrics();
+    std::cout << "Maker metrics:\n" << maker_metrics.dump(2) << "\n";
+  }
+
+  // The flushes at the end are left out: they're not the steady state.
+  int status = 0;
+  auto report = [&](const std::string& stage, const AllocationCounts& counts, uint64_t n_inputs, const char* input) {
+    double per_input = n_inputs ? static_cast<double>(counts.n_allocations) / n_inputs : 0.;
+    if (report_allocations)
+      std::cout << "  " << stage << " maker: " << per_input << " allocations and "
+                << (n_inputs ? static_cast<double>(counts.n_bytes) / n_inputs : 0.) << " bytes per " << input
+                << " over " << n_inputs << " " << input << "s\n";
+    if (allocation_budget.contains(stage) && per_input > allocation_budget[stage].get<double>()) {
+      std::cerr << "The " << stage << " maker made " << per_input << " allocations per " << input
+                << ", over its budget of " << allocation_budget[stage].get<double>() << "\n";
+      status = 2;
+    }
+  };
+  if (report_allocations)
+    std::cout << "Allocations after the first " << warmup_tps << " TPs:\n";
+  report("activity", ta_allocations, n_steady_tps, "TP");
+  if (tc_maker)
+    report("candidate", tc_allocations, n_steady_tas, "TA");
+
+  return status;
+}
@@ -12,14 +12,20 @@
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
 
+#include <deque>
 #include <vector>
 
 namespace triggeralgs {
-class TriggerActivityMakerADCSimpleWindow : public TriggerActivityMaker
+class TriggerActivityMakerADCSimpleWindow final : public TriggerActivityMaker
 {
 
 public:
+  TriggerActivityMakerADCSimpleWindow() { m_metrics.set_supported(); }
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta) override;
+
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, OutputSink<TriggerActivity>& output_ta) override;
   
   void configure(const nlohmann::json &config);
 
@@ -86,14 +92,55 @@ private:
       std::vector<TriggerPrimitive> tp_list;
   };
 
+  // ADC summed into fixed-width time buckets. The buckets hold running (prefix) sums in a
+  // circular array, so the ADC in the last n buckets is one subtraction whatever n is, and
+  // any number of window lengths can be read from the same buckets. TPs are only copied
+  // out of the buffer when a TA is made.
+  class BucketWindow {
+    public:
+      void configure(timestamp_t bucket_width, int64_t max_buckets);
+      // Add a TP, or return false if it belongs in a bucket before the current one.
+      bool add(TriggerPrimitive const &input_tp);
+      // Total ADC of the TPs in the current bucket and the n_buckets-1 before it.
+      uint64_t adc_integral(int64_t n_buckets) const;
+      // Append the TPs counted by adc_integral(n_buckets) to inputs.
+      void fill_inputs(int64_t n_buckets, std::vector<TriggerPrimitive> &inputs) const;
+      // Drop everything added so far.
+      void reset();
+      // Number of TPs held, including those older than the longest window.
+      size_t size() const { return m_tp_buffer.size(); }
+
+    private:
+      uint64_t prefix(int64_t bucket) const;
+
+      timestamp_t m_bucket_width = 1;
+      int64_t m_max_buckets = 1;
+      int64_t m_current_bucket = 0;
+      int64_t m_base_bucket = 0;   // Bucket the window was last reset in
+      uint64_t m_base_sum = 0;     // Running sum at the last reset
+      bool m_empty = true;
+      std::vector<uint64_t> m_prefix_sums;
+      std::deque<TriggerPrimitive> m_tp_buffer;
+  };
+
+  void process_bucketed(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta);
+
   TriggerActivity construct_ta() const;
+  TriggerActivity construct_bucketed_ta(uint64_t adc_integral, int64_t n_buckets) const;
 
   Window m_current_window;
   uint64_t m_primitive_count = 0;
 
+  BucketWindow m_bucket_window;
+  std::vector<int64_t> m_window_buckets;     // Length of each window, in buckets
+  std::vector<uint64_t> m_window_thresholds; // ADC threshold of each window
+
   // Configurable parameters.
   uint32_t m_adc_threshold = 1200000;
   timestamp_t m_window_length = 100000;
+  timestamp_t m_bucket_width = 0;            // Use the bucketed windows if non-zero
+  std::vector<timestamp_t> m_window_lengths; // Bucketed mode only, defaults to window_length
+  std::vector<uint64_t> m_adc_thresholds;    // Bucketed mode only, defaults to adc_threshold
 };
 } // namespace triggeralgs
 
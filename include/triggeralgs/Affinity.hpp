@@ -0,0 +1,25 @@
+/* @file: Affinity.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_AFFINITY_HPP_
+#define TRIGGERALGS_AFFINITY_HPP_
+
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Restricts the calling thread to the given CPU cores.
+///
+/// Memory is placed on the NUMA node of the core that first writes to it, so a worker should
+/// pin itself before building its maker and buffers. An empty list leaves the thread alone.
+/// Returns false if the affinity couldn't be set, eg for a core that doesn't exist.
+bool
+pin_current_thread(const std::vector<int>& cores);
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_AFFINITY_HPP_
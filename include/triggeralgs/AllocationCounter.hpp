@@ -0,0 +1,63 @@
+/* @file: AllocationCounter.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_ALLOCATIONCOUNTER_HPP_
+#define TRIGGERALGS_ALLOCATIONCOUNTER_HPP_
+
+#include <cstdint>
+
+namespace triggeralgs {
+
+/// @brief Heap allocations made by one thread.
+struct AllocationCounts
+{
+  uint64_t n_allocations = 0;
+  uint64_t n_bytes = 0;
+  uint64_t n_deallocations = 0;
+
+  AllocationCounts& operator+=(const AllocationCounts& other)
+  {
+    n_allocations += other.n_allocations;
+    n_bytes += other.n_bytes;
+    n_deallocations += other.n_deallocations;
+    return *this;
+  }
+  AllocationCounts operator-(const AllocationCounts& other) const
+  {
+    return { n_allocations - other.n_allocations, n_bytes - other.n_bytes, n_deallocations - other.n_deallocations };
+  }
+};
+
+/// @brief Whether the library was built with TRIGGERALGS_COUNT_ALLOCATIONS. Only then does it
+/// replace the global operator new and delete with versions that count, per thread, every
+/// allocation made in the process; otherwise the counts stay at zero.
+bool allocation_counting_enabled();
+
+/// @brief What the calling thread has allocated so far.
+AllocationCounts get_thread_allocations();
+
+/// @brief What the calling thread allocates between construction and get(). Eg, to see what a
+/// maker allocates for one TP:
+///
+///   AllocationScope scope;
+///   (*maker)(tp, tas);
+///   n_allocations += scope.get().n_allocations;
+class AllocationScope
+{
+public:
+  AllocationScope()
+    : m_start(get_thread_allocations())
+  {}
+  AllocationCounts get() const { return get_thread_allocations() - m_start; }
+
+private:
+  AllocationCounts m_start;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_ALLOCATIONCOUNTER_HPP_
@@ -18,6 +18,7 @@ namespace triggeralgs {
 class TriggerActivityMakerBundleN : public TriggerActivityMaker
 {
   public:
+    using TriggerActivityMaker::operator();
     void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_tas);
     void configure(const nlohmann::json& config);
     bool bundle_condition();
@@ -18,6 +18,7 @@ namespace triggeralgs {
 class TriggerCandidateMakerBundleN : public TriggerCandidateMaker
 {
   public:
+    using TriggerCandidateMaker::operator();
     void operator()(const TriggerActivity& input_ta, std::vector<TriggerCandidate>& output_tcs);
     void configure(const nlohmann::json& config);
     bool bundle_condition();
@@ -0,0 +1,46 @@
+/**
+ * @file CandidatePipeline.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_CANDIDATEPIPELINE_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_CANDIDATEPIPELINE_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TAStore.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidate.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerPrimitive.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <nlohmann/json.hpp>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief A TA maker and the TC maker it feeds, run as one TP in, TC out stage.
+class CandidatePipeline
+{
+public:
+  virtual ~CandidatePipeline() = default;
+  virtual void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerCandidate>& output_tc) = 0;
+  /// @brief Called when no more TPs with time_start < `until` will arrive. Flushes the TA maker
+  /// up to `until` and the TC maker `candidate_delay` ticks behind.
+  virtual void flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc) = 0;
+  virtual void configure(const nlohmann::json&) {}
+  /// Number of TAs passed from the TA maker to the TC maker
+  virtual uint64_t get_n_activities() const = 0;
+  /// As TriggerCandidateMaker::get_activity_store(), for the TC maker
+  virtual const TAStore* get_activity_store() const = 0;
+  /// As TriggerCandidateMaker::resolve(), for the TC maker
+  virtual bool resolve(TriggerCandidate& tc) = 0;
+  /// As TriggerActivityMaker::enable_metrics(), for both makers
+  virtual void enable_metrics(bool enable = true) = 0;
+  /// The get_metrics() of the TA and TC makers, under "activity" and "candidate"
+  virtual nlohmann::json get_metrics() const = 0;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_CANDIDATEPIPELINE_HPP_
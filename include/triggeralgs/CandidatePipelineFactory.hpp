@@ -0,0 +1,27 @@
+/* @file: CandidatePipelineFactory.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_CANDIDATE_PIPELINE_FACTORY_HPP_
+#define TRIGGERALGS_CANDIDATE_PIPELINE_FACTORY_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/CandidatePipeline.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/AbstractFactory.hpp"
+
+#define REGISTER_CANDIDATE_PIPELINE(pipeline_name, pipeline_class)                                                                                \
+  static struct pipeline_class##Registrar {                                                                                                       \
+    pipeline_class##Registrar() {                                                                                                                 \
+      CandidatePipelineFactory::register_creator(pipeline_name, []() -> std::unique_ptr<CandidatePipeline> {return std::make_unique<pipeline_class>();}); \
+    }                                                                                                                                             \
+  } pipeline_class##_registrar;
+
+namespace triggeralgs {
+
+class CandidatePipelineFactory : public AbstractFactory<CandidatePipeline> {};
+
+} /* namespace triggeralgs */
+
+#endif // TRIGGERALGS_CANDIDATE_PIPELINE_FACTORY_HPP_
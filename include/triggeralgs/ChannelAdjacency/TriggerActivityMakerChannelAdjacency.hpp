@@ -12,21 +12,45 @@
 #include "dunetrigger/triggeralgs/include/triggeralgs/TPWindow.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
 #include <fstream>
+#include <utility>
 #include <vector>
 
 namespace triggeralgs {
-class TriggerActivityMakerChannelAdjacency : public TriggerActivityMaker
+class TriggerActivityMakerChannelAdjacency final : public TriggerActivityMaker
 {
 public:
+  TriggerActivityMakerChannelAdjacency() { m_metrics.set_supported(); }
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
   void configure(const nlohmann::json& config);
 
 private:
-  TriggerActivity construct_ta(TPWindow) const;
+  // One entry per hit channel in the current window, ordered by channel.
+  struct ChannelOccupancy
+  {
+    channel_t channel;
+    const TriggerPrimitive* first_tp; // First TP on this channel, in window order
+    const TriggerPrimitive* last_tp;  // Last TP on this channel, in window order
+  };
 
-  TPWindow check_adjacency();
+  // Build the TA from the track held in m_channel_occupancy[begin, end).
+  TriggerActivity construct_ta(size_t begin, size_t end) const;
+
+  // Fills m_adjacent_tracks with every non-overlapping track in the current window.
+  void check_adjacency();
+
+  // Makes a TA from each track in m_adjacent_tracks, subject to the prescale.
+  void emit_adjacent_tracks(std::vector<TriggerActivity>& output_ta);
 
   TPWindow m_current_window;
+  bool m_window_checked = false; // A flush found no track, and the window hasn't changed since
+
+  // Scratch buffers for check_adjacency(), kept as members so their capacity is reused.
+  std::vector<const TriggerPrimitive*> m_sorted_tps;
+  std::vector<ChannelOccupancy> m_channel_occupancy;
+  std::vector<std::pair<size_t, size_t>> m_adjacent_tracks; // [begin, end) in m_channel_occupancy
 
   // Configurable parameters.
   bool m_print_tp_info = false;        // Prints out some information on every TP received
@@ -36,9 +60,11 @@ private:
   uint16_t m_ta_count = 0;             // Use for prescaling
   uint16_t m_prescale = 1;             // Prescale value, defult is one, trigger every TA
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
   // For debugging and performance study purposes.
   void add_window_to_record(TPWindow window);
   std::vector<TPWindow> m_window_record;
+#endif
 };
 } // namespace triggeralgs
 #endif // TRIGGERALGS_CHANNELADJACENCY_TRIGGERACTIVITYMAKERCHANNELADJACENCY_HPP_
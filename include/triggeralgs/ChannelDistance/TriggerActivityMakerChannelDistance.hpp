@@ -11,23 +11,47 @@
 
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
 #include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
 
 namespace triggeralgs {
 
 class TriggerActivityMakerChannelDistance : public TriggerActivityMaker {
   public:
+    using TriggerActivityMaker::operator();
+    using TriggerActivityMaker::flush;
     void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_tas);
+    void flush(timestamp_t until, std::vector<TriggerActivity>& output_tas);
     void configure(const nlohmann::json& config);
     void set_ta_attributes();
 
   private:
     void set_new_ta(const TriggerPrimitive& input_tp);
+    void set_ta_attributes(TriggerActivity& ta) const;
     TriggerActivity m_current_ta;
     uint32_t m_max_channel_distance = 50;
     uint64_t m_window_length = 8000;
     uint16_t m_min_tps = 20; // AEO: Type is arbitrary. Surprised even asking for 2^8 TPs.
     uint32_t m_current_lower_bound;
     uint32_t m_current_upper_bound;
+
+    // Multi-cluster mode: keep any number of open TAs, each covering its own channel range.
+    bool m_multi_cluster = false;
+
+    struct Cluster
+    {
+      channel_t channel_end; // Highest TP channel in the cluster
+      TriggerActivity ta;    // TPs in time order
+    };
+
+    void add_to_clusters(const TriggerPrimitive& input_tp);
+    void close_expired_clusters(timestamp_t now, std::vector<TriggerActivity>& output_tas);
+
+    // Open clusters keyed by their lowest TP channel. The channel ranges never overlap.
+    std::map<channel_t, Cluster> m_clusters;
+    // (first TP time_start, key in m_clusters) of every open cluster, earliest first.
+    std::set<std::pair<timestamp_t, channel_t>> m_cluster_expiry;
 };
 
 } // namespace triggeralgs
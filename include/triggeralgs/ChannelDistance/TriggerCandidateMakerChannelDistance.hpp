@@ -16,6 +16,7 @@ namespace triggeralgs {
 
 class TriggerCandidateMakerChannelDistance : public TriggerCandidateMaker {
   public:
+    using TriggerCandidateMaker::operator();
     void operator()(const TriggerActivity& input_ta, std::vector<TriggerCandidate>& output_tcs);
     void configure(const nlohmann::json& config);
     void set_tc_attributes();
@@ -0,0 +1,66 @@
+/**
+ * @file TriggerDecisionMakerCoalescing.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_COALESCING_TRIGGERDECISIONMAKERCOALESCING_HPP_
+#define TRIGGERALGS_COALESCING_TRIGGERDECISIONMAKERCOALESCING_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerDecisionFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+class TriggerDecisionMakerCoalescing : public TriggerDecisionMaker
+{
+  /// This decision maker holds candidates for up to `latency` ticks of data time and merges
+  /// those whose readout windows overlap, or are within `merge_gap` ticks of each other, into
+  /// a single decision.
+
+public:
+  TriggerDecisionMakerCoalescing() { m_metrics.set_supported(); }
+  using TriggerDecisionMaker::operator();
+  void operator()(const TriggerCandidate& input_tc, std::vector<TriggerDecision>& output_tds) override;
+
+  /// Emit every pending decision, whatever its age
+  void flush(std::vector<TriggerDecision>& output_tds) override;
+  /// Emit the pending decisions that have waited `latency` ticks by `until`
+  void flush(timestamp_t until, std::vector<TriggerDecision>& output_tds) override;
+
+  void configure(const nlohmann::json& config) override;
+
+private:
+  struct PendingDecision
+  {
+    timestamp_t opened; // Data time when the first TC in the decision arrived
+    TriggerDecision td;
+  };
+
+  void emit(std::map<timestamp_t, PendingDecision>::iterator it, std::vector<TriggerDecision>& output_tds);
+  /// Move data time on to `now`, if it is later, and emit the decisions that are old enough
+  void release(timestamp_t now, std::vector<TriggerDecision>& output_tds);
+
+  /// Pending decisions keyed by readout time_start. Their readout windows never overlap.
+  std::map<timestamp_t, PendingDecision> m_pending;
+  /// (opened, key in m_pending) of every pending decision, oldest first
+  std::set<std::pair<timestamp_t, timestamp_t>> m_pending_age;
+
+  trigger_number_t m_trigger_number = 0;
+  /// Latest time_candidate, or flush time, seen. TCs from different makers arrive out of
+  /// order, so a single TC's time can be behind the decisions already pending.
+  timestamp_t m_data_time = 0;
+
+  // Configurable parameters.
+  timestamp_t m_latency = 62'500;  // How long a decision may wait for more candidates, in ticks of data time
+  timestamp_t m_merge_gap = 0;     // Readout windows closer than this are merged
+};
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_COALESCING_TRIGGERDECISIONMAKERCOALESCING_HPP_
@@ -0,0 +1,104 @@
+/**
+ * @file TriggerActivityMakerComposite.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_COMPOSITE_TRIGGERACTIVITYMAKERCOMPOSITE_HPP_
+#define TRIGGERALGS_COMPOSITE_TRIGGERACTIVITYMAKERCOMPOSITE_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief TP window shared by every condition of a TriggerActivityMakerComposite.
+///
+/// TPs are kept once, in time order, with the running ADC sum and per channel hit counts.
+/// The channel counts are ordered by channel so that adjacency needs no sort. Old TPs are
+/// dropped by moving the start index, and the storage is compacted once half of it is dead.
+class SharedTPWindow
+{
+public:
+  bool is_empty() const { return m_first == m_tps.size(); }
+  size_t size() const { return m_tps.size() - m_first; }
+  timestamp_t time_start() const { return m_tps[m_first].time_start; }
+  uint16_t n_channels_hit() const { return channel_counts.size(); }
+
+  std::vector<TriggerPrimitive>::const_iterator begin() const { return m_tps.begin() + m_first; }
+  std::vector<TriggerPrimitive>::const_iterator end() const { return m_tps.end(); }
+  const TriggerPrimitive& back() const { return m_tps.back(); }
+
+  void add(const TriggerPrimitive& input_tp);
+  void clear();
+  void reset(const TriggerPrimitive& input_tp);
+  /// Drops the TPs that input_tp would push out of a window_length window, then adds it.
+  void move(const TriggerPrimitive& input_tp, timestamp_t window_length);
+
+  uint64_t adc_integral = 0;
+  std::map<channel_t, uint16_t> channel_counts;
+
+private:
+  std::vector<TriggerPrimitive> m_tps;
+  size_t m_first = 0;
+};
+
+/// @brief A trigger condition evaluated against the shared window when it closes.
+class CompositeCondition
+{
+public:
+  virtual ~CompositeCondition() = default;
+  virtual bool operator()(const SharedTPWindow& window) const = 0;
+  virtual void configure(const nlohmann::json& config) = 0;
+  /// Algorithm recorded in the TA when this condition is the one that fired.
+  virtual TriggerActivity::Algorithm algorithm() const = 0;
+};
+
+/// @brief Runs several trigger conditions over one TP window.
+///
+/// The window follows the same pattern as HorizontalMuon: once a TP arrives more than
+/// window_length after the window start, the conditions listed in `conditions` are checked in
+/// order. If one fires, a TA is made from the whole window and the window restarts with that TP.
+/// Otherwise the window slides along. Conditions are built by name from register_condition().
+///
+/// With the adc, n_channels and adjacency conditions in that order, it finds the same windows
+/// as HorizontalMuon. It is not a drop-in for running one maker per condition side by side:
+/// those each keep their own window, so each can make a TA from the same TPs, while here the
+/// first condition to fire takes the window and the others are not checked on it.
+class TriggerActivityMakerComposite : public TriggerActivityMaker
+{
+public:
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) override;
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta) override;
+  void configure(const nlohmann::json& config) override;
+
+  using ConditionCreator = std::function<std::unique_ptr<CompositeCondition>()>;
+  static void register_condition(const std::string& type, ConditionCreator creator);
+
+private:
+  const CompositeCondition* check_conditions() const;
+  TriggerActivity construct_ta(const CompositeCondition& fired) const;
+
+  static std::map<std::string, ConditionCreator>& condition_registry();
+
+  SharedTPWindow m_current_window;
+  std::vector<std::unique_ptr<CompositeCondition>> m_conditions;
+  uint64_t m_n_triggered = 0;
+
+  // Configurable parameters.
+  timestamp_t m_window_length = 8000;
+  uint64_t m_prescale = 1;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_COMPOSITE_TRIGGERACTIVITYMAKERCOMPOSITE_HPP_
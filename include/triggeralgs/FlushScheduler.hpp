@@ -0,0 +1,60 @@
+/**
+ * @file FlushScheduler.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_FLUSHSCHEDULER_HPP_
+#define TRIGGERALGS_FLUSHSCHEDULER_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityMaker.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateMaker.hpp"
+
+#include <nlohmann/json.hpp>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Drives the flushes of a TA maker and the TC maker fed by it from data time.
+///
+/// Window-based makers only act on a full window when the next input arrives, so on a quiet
+/// detector a TA can be held indefinitely. The scheduler learns the data time from the TPs
+/// it is given and from heartbeat() (eg readout time sync), and every `flush_interval` ticks
+/// flushes the TA maker up to that time, passes any TAs on and flushes the TC maker.
+///
+/// A TA is then held at most `flush_interval` ticks past the end of its window. The TC maker
+/// is flushed `candidate_delay` ticks behind, as a TA still open in the TA maker can start
+/// that much earlier; it should be at least the TA maker's window length.
+class FlushScheduler
+{
+public:
+  FlushScheduler(TriggerActivityMaker& ta_maker, TriggerCandidateMaker& tc_maker);
+
+  void configure(const nlohmann::json& config);
+
+  /// @brief Run a TP through both makers. TPs must be in time_start order.
+  void operator()(const TriggerPrimitive& input_tp,
+                  std::vector<TriggerActivity>& output_ta,
+                  std::vector<TriggerCandidate>& output_tc);
+
+  /// @brief No more TPs with time_start before `time` will arrive
+  void heartbeat(timestamp_t time, std::vector<TriggerActivity>& output_ta, std::vector<TriggerCandidate>& output_tc);
+
+private:
+  // Runs output_ta[first_ta:] through the TC maker.
+  void make_candidates(size_t first_ta, std::vector<TriggerActivity>& output_ta, std::vector<TriggerCandidate>& output_tc);
+
+  TriggerActivityMaker& m_ta_maker;
+  TriggerCandidateMaker& m_tc_maker;
+  timestamp_t m_next_flush = 0;
+
+  // Configurable parameters.
+  timestamp_t m_flush_interval = 6250;  // 100 us
+  timestamp_t m_candidate_delay = 8000; // Default window length of the TP window makers
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_FLUSHSCHEDULER_HPP_
@@ -0,0 +1,63 @@
+/**
+ * @file FusedCandidateMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_FUSEDCANDIDATEMAKER_HPP_
+#define TRIGGERALGS_FUSEDCANDIDATEMAKER_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/CandidatePipelineFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateFactory.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief A CandidatePipeline of any TA maker and TC maker from their factories.
+///
+/// Builds the TA maker named by `activity_maker` and the TC maker named by `candidate_maker`
+/// (configured with `activity_config` and `candidate_config`). Each TA is moved straight into
+/// the TC maker, so makers that keep their TAs take the TP list without copying it, and the
+/// TA buffer is reused from one TP to the next.
+///
+/// flush(until) flushes the TA maker up to `until` and the TC maker `candidate_delay` ticks
+/// behind, as in FlushScheduler. The calls between the makers are virtual; for a pair fixed
+/// at compile time use Pipeline instead.
+class FusedCandidateMaker : public CandidatePipeline
+{
+public:
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerCandidate>& output_tc) override;
+  void flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc) override;
+  void configure(const nlohmann::json& config) override;
+
+  uint64_t get_n_activities() const override { return m_n_activities; }
+  const TAStore* get_activity_store() const override { return m_tc_maker ? m_tc_maker->get_activity_store() : nullptr; }
+  bool resolve(TriggerCandidate& tc) override { return !m_tc_maker || m_tc_maker->resolve(tc); }
+  void enable_metrics(bool enable = true) override;
+  nlohmann::json get_metrics() const override;
+
+private:
+  // Moves every TA in m_activities into the TC maker and empties it.
+  void make_candidates(std::vector<TriggerCandidate>& output_tc);
+
+  std::unique_ptr<TriggerActivityMaker> m_ta_maker;
+  std::unique_ptr<TriggerCandidateMaker> m_tc_maker;
+  std::vector<TriggerActivity> m_activities;
+  uint64_t m_n_activities = 0;
+  bool m_metrics_enabled = false; // Applied to the makers when configure() builds them
+
+  // Configurable parameters.
+  std::string m_ta_maker_name;
+  std::string m_tc_maker_name;
+  timestamp_t m_candidate_delay = 8000; // Default window length of the TP window makers
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_FUSEDCANDIDATEMAKER_HPP_
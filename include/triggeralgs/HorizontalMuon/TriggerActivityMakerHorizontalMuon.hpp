@@ -15,10 +15,18 @@
 #include <vector>
 
 namespace triggeralgs {
-class TriggerActivityMakerHorizontalMuon : public TriggerActivityMaker
+class TriggerActivityMakerHorizontalMuon final : public TriggerActivityMaker
 {
 public:
+  TriggerActivityMakerHorizontalMuon()
+  {
+    m_metrics.set_supported();
+    m_metrics.set_condition_names({ "adc", "n_channels", "adjacency", "tot" });
+  }
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta) override;
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, OutputSink<TriggerActivity>& output_ta) override;
   void configure(const nlohmann::json& config);
 
 private:
@@ -26,6 +34,7 @@ private:
   uint16_t check_adjacency() const; // Returns longest string of adjacent collection hits in window
 
   TPWindow m_current_window; // Holds collection hits only
+  mutable std::vector<int> m_channel_list; // Sorted channels of the window, for check_adjacency()
   int check_tot() const;
 
   // Configurable parameters.
@@ -47,11 +56,13 @@ private:
   uint16_t ta_count = 0;              // Use for prescaling
   uint16_t m_prescale = 1;            // Prescale value, defult is one, trigger every TA
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
   // For debugging and performance study purposes.
   void add_window_to_record(TPWindow window);
   void dump_window_record();
   void dump_tp(TriggerPrimitive const& input_tp);
   std::vector<TPWindow> m_window_record;
+#endif
 };
 } // namespace triggeralgs
 #endif // TRIGGERALGS_HORIZONTALMUON_TRIGGERACTIVITYMAKERHORIZONTALMUON_HPP_
@@ -16,13 +16,23 @@
 #include <vector>
 
 namespace triggeralgs {
-class TriggerCandidateMakerHorizontalMuon : public TriggerCandidateMaker
+class TriggerCandidateMakerHorizontalMuon final : public TriggerCandidateMaker
 {
 
 public:
+  TriggerCandidateMakerHorizontalMuon()
+  {
+    m_metrics.set_supported();
+    m_metrics.set_condition_names({ "adc", "n_channels" });
+  }
+  using TriggerCandidateMaker::operator();
   // The function that gets called when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
+  void operator()(TriggerActivity&&, std::vector<TriggerCandidate>&);
+  void operator()(const TriggerActivity&, OutputSink<TriggerCandidate>&) override;
+  void operator()(TriggerActivity&&, OutputSink<TriggerCandidate>&) override;
   void configure(const nlohmann::json& config);
+  const TAStore* get_activity_store() const override { return m_reference_inputs ? &m_activity_store : nullptr; }
 
 private:
 
@@ -30,6 +40,7 @@ private:
   bool check_adjacency() const;
 
   TAWindow m_current_window;
+  TAStore m_activity_store;
   uint64_t m_activity_count = 0; // NOLINT(build/unsigned)
 
   // Configurable parameters.
@@ -40,12 +51,15 @@ private:
   timestamp_t m_window_length = 80000;
   timestamp_t m_readout_window_ticks_before = 32768;
   timestamp_t m_readout_window_ticks_after = 32768;
+  bool m_reference_inputs = false; // Give TCs input_refs into m_activity_store instead of inputs
   int tc_number = 0;
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
   // For debugging purposes.
   void add_window_to_record(TAWindow window);
   void dump_window_record();
   std::vector<TAWindow> m_window_record;
+#endif
 };
 } // namespace triggeralgs
 #endif // TRIGGERALGS_HORIZONTALMUON_TRIGGERCANDIDATEMAKERHORIZONTALMUON_HPP_
@@ -0,0 +1,73 @@
+/* @file: LatencyHistogram.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_LATENCYHISTOGRAM_HPP_
+#define TRIGGERALGS_LATENCYHISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace triggeralgs {
+
+/// @brief A histogram of non-negative values in log-linear buckets, as in HdrHistogram.
+///
+/// Values below 2^s_sub_bits have a bucket each; above that every power of two is split into
+/// 2^s_sub_bits buckets, so a value is known to within 1/16 (6%) of itself over the whole
+/// 64-bit range, in under a thousand buckets. record() finds the bucket from the position of
+/// the value's highest bit, a shift and a mask, and bumps it. As in MakerMetrics there is one
+/// writer and the counts are relaxed atomics, so get_json() can be called from any thread.
+class LatencyHistogram
+{
+public:
+  static constexpr int s_sub_bits = 4;
+  static constexpr uint64_t s_sub_buckets = uint64_t(1) << s_sub_bits;
+  static constexpr size_t s_n_buckets = (64 - s_sub_bits + 1) * s_sub_buckets;
+
+  static size_t bucket(uint64_t value)
+  {
+    if (value < s_sub_buckets)
+      return value;
+    int shift = 63 - __builtin_clzll(value) - s_sub_bits;
+    return ((shift + 1) << s_sub_bits) + ((value >> shift) & (s_sub_buckets - 1));
+  }
+  /// @brief The largest value that falls in bucket `index`
+  static uint64_t bucket_max(size_t index);
+
+  void record(uint64_t value)
+  {
+    add(m_counts[bucket(value)], 1);
+    add(m_count, 1);
+    add(m_sum, value);
+    if (value > m_max.load(std::memory_order_relaxed))
+      m_max.store(value, std::memory_order_relaxed);
+  }
+
+  uint64_t get_count() const { return m_count.load(std::memory_order_relaxed); }
+  /// @brief The value at or below which a fraction `quantile` of the recorded values lie, to
+  /// bucket precision
+  uint64_t get_quantile(double quantile) const;
+
+  /// @brief count, mean, p50, p90, p99, p99.9 and max
+  nlohmann::json get_json() const;
+
+private:
+  static void add(std::atomic<uint64_t>& counter, uint64_t n)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<uint64_t>, s_n_buckets> m_counts{};
+  std::atomic<uint64_t> m_count{ 0 };
+  std::atomic<uint64_t> m_sum{ 0 };
+  std::atomic<uint64_t> m_max{ 0 };
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_LATENCYHISTOGRAM_HPP_
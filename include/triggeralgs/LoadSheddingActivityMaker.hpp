@@ -0,0 +1,108 @@
+/**
+ * @file LoadSheddingActivityMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_LOADSHEDDINGACTIVITYMAKER_HPP_
+#define TRIGGERALGS_LOADSHEDDINGACTIVITYMAKER_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief A change of shedding level, kept for offline accounting of what was not triggered on.
+struct LoadSheddingDecision
+{
+  timestamp_t data_time; // time_start of the TP being processed
+  int64_t wall_ns;       // steady_clock time of the decision
+  uint16_t from_level;
+  uint16_t to_level;
+  uint64_t backlog; // As last given to set_backlog()
+  int64_t lag;      // Data time lag behind wall time, in ticks
+};
+
+/// @brief Runs the TA maker named by `maker`, shedding load when it can't keep up.
+///
+/// Every `check_interval` TPs the load is compared with its budget: the input backlog given
+/// by the caller through set_backlog() against `max_backlog`, and how far data time has
+/// fallen behind wall time against `max_lag` (ticks at `clock_frequency_hz`, measured from
+/// the smallest lag seen). A zero budget disables that check. Each check over budget, where
+/// the load is not already falling, raises the shedding level by one up to `max_level`. After
+/// `recover_checks` checks in a row at under half of every budget it drops by one.
+///
+/// At level n the TPs are prescaled by 2^n in blocks of `block_length` ticks: only one block
+/// in 2^n is passed on, and the maker is flushed at the start of each dropped block so no
+/// window is left open across it. If a `fallback_maker` is configured, level 1 switches to
+/// it instead and the prescale starts from level 2. Every level change is logged, and the last
+/// `max_decisions` (1024 by default, 0 for none) are kept in get_decisions(), oldest first.
+class LoadSheddingActivityMaker : public TriggerActivityMaker
+{
+public:
+  LoadSheddingActivityMaker() { m_metrics.set_supported(); }
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) override;
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta) override;
+  void configure(const nlohmann::json& config) override;
+  /// @brief Also turns on the counters of the wrapped makers
+  void enable_metrics(bool enable = true) override;
+  /// @brief Counts shed TPs as drops, with the wrapped makers' own metrics under "maker" and
+  /// "fallback"
+  nlohmann::json get_metrics() const override;
+
+  /// @brief Number of inputs waiting upstream, eg the depth of the input queue
+  void set_backlog(uint64_t backlog) { m_backlog = backlog; }
+
+  uint16_t get_level() const { return m_level; }
+  uint64_t get_n_shed() const { return m_n_shed; }
+  const std::deque<LoadSheddingDecision>& get_decisions() const { return m_decisions; }
+  /// @brief Level changes that were dropped from get_decisions() to keep it at max_decisions
+  uint64_t get_n_decisions_dropped() const { return m_n_decisions_dropped; }
+
+private:
+  void check_load(timestamp_t data_time, std::vector<TriggerActivity>& output_ta);
+  void set_level(uint16_t level, timestamp_t data_time, int64_t wall_ns, int64_t lag, std::vector<TriggerActivity>& output_ta);
+  TriggerActivityMaker& active_maker() const;
+  uint64_t block_prescale() const;
+
+  std::unique_ptr<TriggerActivityMaker> m_maker;
+  std::unique_ptr<TriggerActivityMaker> m_fallback;
+  uint16_t m_level = 0;
+  uint64_t m_backlog = 0;
+  uint64_t m_n_since_check = 0;
+  uint64_t m_n_calm_checks = 0;
+  uint64_t m_n_shed = 0;
+  bool m_maker_fed = false; // Whether the active maker has had a TP since it was last flushed
+  bool m_started = false;
+  timestamp_t m_data_start = 0;
+  int64_t m_wall_start_ns = 0;
+  int64_t m_min_offset = 0;
+  uint64_t m_last_backlog = 0;
+  int64_t m_last_lag = 0;
+  std::deque<LoadSheddingDecision> m_decisions;
+  uint64_t m_n_decisions_dropped = 0;
+
+  // Configurable parameters.
+  std::string m_maker_name;
+  std::string m_fallback_name;
+  uint64_t m_max_backlog = 0;
+  int64_t m_max_lag = 0;
+  double m_clock_frequency_hz = 62.5e6;
+  uint64_t m_check_interval = 1024;
+  uint64_t m_recover_checks = 8;
+  uint16_t m_max_level = 4;
+  timestamp_t m_block_length = 62500; // 1 ms
+  size_t m_max_decisions = 1024;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_LOADSHEDDINGACTIVITYMAKER_HPP_
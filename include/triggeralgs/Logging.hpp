@@ -27,4 +27,28 @@ enum Logging
 
 } // namespace triggeralgs
 
+/**
+* @brief The most detailed TLOG_DEBUG level compiled into the library. Statements logged with
+* TRIGGERALGS_TLOG_DEBUG at a higher level are discarded at compile time, along with the
+* expressions they stream, so they cost nothing even when TRACE would have kept them. Builds
+* with TRIGGERALGS_NO_DIAGNOSTICS stop at TLVL_DEBUG_MEDIUM; others keep every level and leave
+* the choice to TRACE at run time, as before.
+*/
+#ifndef TRIGGERALGS_TRACE_LEVEL
+#ifdef TRIGGERALGS_NO_DIAGNOSTICS
+#define TRIGGERALGS_TRACE_LEVEL 10
+#else
+#define TRIGGERALGS_TRACE_LEVEL 20
+#endif
+#endif
+
+/**
+* @brief TLOG_DEBUG(lvl), unless lvl is above TRIGGERALGS_TRACE_LEVEL. The empty branch
+* keeps an else after an unbraced `if (x) TRIGGERALGS_TLOG_DEBUG(...) << ...;` on the if.
+*/
+#define TRIGGERALGS_TLOG_DEBUG(lvl)                                    \
+  if constexpr (!(static_cast<int>(lvl) <= TRIGGERALGS_TRACE_LEVEL)) { \
+  } else                                                               \
+    TLOG_DEBUG(lvl)
+
 #endif // TRIGGERALGS_INCLUDE_LOGGING_HPP_
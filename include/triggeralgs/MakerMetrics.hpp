@@ -0,0 +1,225 @@
+/* @file: MakerMetrics.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_MAKERMETRICS_HPP_
+#define TRIGGERALGS_MAKERMETRICS_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/LatencyHistogram.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Counters a maker keeps about itself: inputs taken, outputs made, how full its window
+/// is, time spent processing, which trigger conditions were met and how many inputs or
+/// outputs it dropped. Makers that call record_arrival() and record_latency() also get
+/// histograms of how long each input waited to go out in an output.
+///
+/// Only the maker's own thread writes the counters, so each update is a relaxed load and
+/// store rather than a locked read-modify-write, and get_json() can read them from any other
+/// thread at any time. The counters share cache lines with each other, which costs nothing
+/// with one writer, but the class is cache line aligned, so they share none with the rest of
+/// the maker. They are off until set_enabled(), and cost one predictable branch per update
+/// until then. The latency histograms and arrival times, some 32 kB, are only allocated then.
+class alignas(64) MakerMetrics
+{
+public:
+  static constexpr size_t s_max_conditions = 4;
+  /// Reading the clock takes tens of ns, as long as some makers take per input, so Scope only
+  /// times one input in this many and scales up: busy_ns is an estimate.
+  static constexpr uint64_t s_timing_interval = 16;
+  /// By default record_arrival() keeps the wall time of one input in this many...
+  static constexpr uint64_t s_arrival_interval = 16;
+  /// ...for this many of them, which is further back than any window goes.
+  static constexpr size_t s_n_arrivals = 1024;
+
+  /// Not thread safe: call before the maker starts.
+  void set_enabled(bool enabled)
+  {
+    m_enabled = enabled;
+    if (enabled && !m_latencies)
+      m_latencies = std::make_unique<Latencies>();
+  }
+  bool is_enabled() const { return m_enabled; }
+  /// @brief Makers that keep the counters say so from their constructor. The others report
+  /// "supported": false and no counters, rather than zeros that look like an idle maker.
+  void set_supported(bool supported = true) { m_supported = supported; }
+  bool is_supported() const { return m_supported; }
+  /// @brief Names for the conditions counted by count_trigger(), in order. Unnamed conditions
+  /// are reported by number. Call from the maker's constructor.
+  void set_condition_names(std::vector<std::string> names) { m_condition_names = std::move(names); }
+
+  void count_inputs(uint64_t n = 1)
+  {
+    if (m_enabled)
+      add(m_n_inputs, n);
+  }
+  void count_outputs(uint64_t n = 1)
+  {
+    if (m_enabled)
+      add(m_n_outputs, n);
+  }
+  void count_drops(uint64_t n = 1)
+  {
+    if (m_enabled)
+      add(m_n_drops, n);
+  }
+  void count_trigger(size_t condition = 0)
+  {
+    if (m_enabled && condition < s_max_conditions)
+      add(m_n_triggers[condition], 1);
+  }
+  /// @brief Number of inputs the maker is holding on to, eg in its window
+  void set_occupancy(uint64_t occupancy)
+  {
+    if (!m_enabled)
+      return;
+    m_occupancy.store(occupancy, std::memory_order_relaxed);
+    if (occupancy > m_occupancy_peak.load(std::memory_order_relaxed))
+      m_occupancy_peak.store(occupancy, std::memory_order_relaxed);
+  }
+
+  /// @brief Notes that the input with time_start `time` has arrived, for record_latency().
+  /// Inputs must arrive in time order. Only one in `interval` is kept, which puts the wall
+  /// latencies up to that many inputs too high: makers with few inputs, like TC makers, should
+  /// keep all of them.
+  void record_arrival(timestamp_t time, uint64_t interval = s_arrival_interval)
+  {
+    if (!m_enabled || m_n_arrivals++ % interval != 0)
+      return;
+    m_latencies->arrivals[m_arrival_head++ % s_n_arrivals] = { time, now_ns() };
+  }
+
+  /// @brief Records the latency of each of an output's `inputs` (TPs, TAs or ActivityRefs), as
+  /// it is emitted at data time `now`: in ticks from the input's time_start to `now`, and in ns
+  /// of wall time from the arrival of the earliest input, as of the last record_arrival() at or
+  /// before it. Eg, next to `output_ta.emit(ta)`:
+  ///
+  ///   m_metrics.record_latency(input_tp.time_start, ta.inputs);
+  template<class Inputs>
+  void record_latency(timestamp_t now, const Inputs& inputs)
+  {
+    if (!m_enabled || inputs.empty())
+      return;
+    timestamp_t earliest = inputs.front().time_start;
+    for (const auto& input : inputs) {
+      m_latencies->data.record(now > input.time_start ? now - input.time_start : 0);
+      earliest = std::min<timestamp_t>(earliest, input.time_start);
+    }
+    record_wall_latency(earliest);
+  }
+
+  /// @brief Counts one input and (for one in s_timing_interval inputs) the time until it goes
+  /// out of scope, and optionally the growth of an output vector over that time. Eg, at the
+  /// top of operator():
+  ///
+  ///   MakerMetrics::Scope scope(m_metrics, output_ta);
+  class Scope
+  {
+  public:
+    explicit Scope(MakerMetrics& metrics)
+      : m_metrics(metrics.m_enabled ? &metrics : nullptr)
+    {
+      if (m_metrics) {
+        uint64_t n_inputs = m_metrics->m_n_inputs.load(std::memory_order_relaxed);
+        m_metrics->m_n_inputs.store(n_inputs + 1, std::memory_order_relaxed);
+        m_timed = n_inputs % s_timing_interval == 0;
+        if (m_timed)
+          m_start = std::chrono::steady_clock::now();
+      }
+    }
+    template<class T>
+    Scope(MakerMetrics& metrics, const std::vector<T>& output)
+      : Scope(metrics)
+    {
+      if (m_metrics) {
+        m_output = &output;
+        m_output_size = [](const void* v) { return static_cast<const std::vector<T>*>(v)->size(); };
+        m_output_size_before = m_output_size(m_output);
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope()
+    {
+      if (!m_metrics)
+        return;
+      if (m_timed) {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        add(m_metrics->m_busy_ns,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() * s_timing_interval);
+      }
+      if (m_output)
+        add(m_metrics->m_n_outputs, m_output_size(m_output) - m_output_size_before);
+    }
+
+  private:
+    MakerMetrics* m_metrics;
+    bool m_timed = false;
+    std::chrono::steady_clock::time_point m_start;
+    const void* m_output = nullptr;
+    size_t (*m_output_size)(const void*) = nullptr;
+    size_t m_output_size_before = 0;
+  };
+
+  /// @brief A snapshot of the counters. Safe to call from any thread.
+  nlohmann::json get_json() const;
+
+private:
+  static void add(std::atomic<uint64_t>& counter, uint64_t n)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+  static int64_t now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+  }
+  void record_wall_latency(timestamp_t earliest);
+
+  std::atomic<uint64_t> m_n_inputs{ 0 };
+  std::atomic<uint64_t> m_n_outputs{ 0 };
+  std::atomic<uint64_t> m_n_drops{ 0 };
+  std::atomic<uint64_t> m_busy_ns{ 0 };
+  std::atomic<uint64_t> m_occupancy{ 0 };
+  std::atomic<uint64_t> m_occupancy_peak{ 0 };
+  std::array<std::atomic<uint64_t>, s_max_conditions> m_n_triggers{};
+  bool m_enabled = false;
+  bool m_supported = false;
+  std::vector<std::string> m_condition_names;
+
+  struct Arrival
+  {
+    timestamp_t time;
+    int64_t wall_ns;
+  };
+  struct Latencies
+  {
+    LatencyHistogram data; // Ticks
+    LatencyHistogram wall; // ns
+    std::array<Arrival, s_n_arrivals> arrivals{}; // Only used by the maker's thread
+  };
+  std::unique_ptr<Latencies> m_latencies; // Allocated by set_enabled(true)
+
+  // Only used by the maker's thread.
+  uint64_t m_n_arrivals = 0;
+  uint64_t m_arrival_head = 0; // Number of arrivals kept so far
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_MAKERMETRICS_HPP_
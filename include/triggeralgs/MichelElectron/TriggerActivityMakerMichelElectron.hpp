@@ -18,8 +18,12 @@ class TriggerActivityMakerMichelElectron : public TriggerActivityMaker
 {
 
 public:
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
 
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+
   void configure(const nlohmann::json& config);
 
 private:
@@ -127,11 +131,13 @@ private:
   uint16_t ta_channels = 0;
   timestamp_t m_window_length = 50000;
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
   // For debugging purposes.
   void add_window_to_record(Window window);
   void dump_window_record();
   void dump_tp(TriggerPrimitive const& input_tp);
   std::vector<Window> m_window_record;
+#endif
 };
 } // namespace triggeralgs
 
@@ -21,12 +21,15 @@ class TriggerCandidateMakerMichelElectron : public TriggerCandidateMaker
 {
 
 public:
+  using TriggerCandidateMaker::operator();
+  using TriggerCandidateMaker::flush;
   /// The function that gets call when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
+  void operator()(TriggerActivity&&, std::vector<TriggerCandidate>&);
 
   void configure(const nlohmann::json& config);
 
-  // void flush(timestamp_t, std::vector<TriggerCandidate>& output_tc);
+  void flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc);
 
 private:
   class Window
@@ -144,10 +147,12 @@ private:
   // Might not be the best type for this map.
   // std::unordered_map<std::pair<detid_t,channel_t>,channel_t> m_channel_map;
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
   // For debugging purposes.
   void add_window_to_record(Window window);
   void dump_window_record();
   std::vector<Window> m_window_record;
+#endif
 };
 } // namespace triggeralgs
 
@@ -0,0 +1,70 @@
+/* @file: OutputSink.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_OUTPUTSINK_HPP_
+#define TRIGGERALGS_OUTPUTSINK_HPP_
+
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Where a maker puts what it makes. Each object is moved in as soon as it is made, so
+/// the receiver takes ownership of it (TP or TA list included) without a copy, and with no
+/// intermediate vector to grow under a burst.
+template<class T>
+class OutputSink
+{
+public:
+  virtual ~OutputSink() = default;
+  virtual void emit(T&& obj) = 0;
+  void emit(const T& obj) { emit(T(obj)); }
+};
+
+/// @brief Appends to a caller-owned vector, as makers have always done.
+template<class T>
+class VectorSink final : public OutputSink<T>
+{
+public:
+  explicit VectorSink(std::vector<T>& output)
+    : m_output(output)
+  {}
+  using OutputSink<T>::emit;
+  void emit(T&& obj) override { m_output.push_back(std::move(obj)); }
+
+private:
+  std::vector<T>& m_output;
+};
+
+/// @brief Hands each object to a callable taking a `T&&`, eg one pushing it onto a queue. Eg
+///
+///   auto sink = make_callback_sink<TriggerActivity>([&](TriggerActivity&& ta) { queue.push(std::move(ta)); });
+///   (*maker)(tp, sink);
+template<class T, class Callback>
+class CallbackSink final : public OutputSink<T>
+{
+public:
+  explicit CallbackSink(Callback callback)
+    : m_callback(std::move(callback))
+  {}
+  using OutputSink<T>::emit;
+  void emit(T&& obj) override { m_callback(std::move(obj)); }
+
+private:
+  Callback m_callback;
+};
+
+template<class T, class Callback>
+CallbackSink<T, Callback>
+make_callback_sink(Callback callback)
+{
+  return CallbackSink<T, Callback>(std::move(callback));
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_OUTPUTSINK_HPP_
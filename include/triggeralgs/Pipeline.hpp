@@ -0,0 +1,98 @@
+/**
+ * @file Pipeline.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_PIPELINE_HPP_
+#define TRIGGERALGS_PIPELINE_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/CandidatePipeline.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityMaker.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateMaker.hpp"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief A TA maker and TC maker fixed at compile time, run as one TP in, TC out stage.
+///
+/// Both makers are held by value and called through their concrete types, so there is no
+/// virtual dispatch between the stages and their calls can be inlined. Only the pipeline's own
+/// operator() is virtual. Each TA is moved into the TC maker and the TA buffer is reused.
+///
+/// Configured with `activity_config`, `candidate_config` and `candidate_delay` as for
+/// FusedCandidateMaker. Pipelines are selected at run time from the CandidatePipelineFactory,
+/// see src/Pipelines.cpp for the instantiated ones.
+template<typename TAM, typename TCM>
+class Pipeline final : public CandidatePipeline
+{
+  static_assert(std::is_base_of<TriggerActivityMaker, TAM>::value, "TAM must be a TriggerActivityMaker");
+  static_assert(std::is_base_of<TriggerCandidateMaker, TCM>::value, "TCM must be a TriggerCandidateMaker");
+
+public:
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerCandidate>& output_tc) override
+  {
+    m_ta_maker(input_tp, m_activities);
+    make_candidates(output_tc);
+  }
+
+  void flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc) override
+  {
+    m_ta_maker.flush(until, m_activities);
+    make_candidates(output_tc);
+    if (until > m_candidate_delay)
+      m_tc_maker.flush(until - m_candidate_delay, output_tc);
+  }
+
+  void configure(const nlohmann::json& config) override
+  {
+    if (config.is_object()) {
+      if (config.contains("activity_config"))
+        m_ta_maker.configure(config["activity_config"]);
+      if (config.contains("candidate_config"))
+        m_tc_maker.configure(config["candidate_config"]);
+      if (config.contains("candidate_delay"))
+        m_candidate_delay = config["candidate_delay"];
+    }
+  }
+
+  uint64_t get_n_activities() const override { return m_n_activities; }
+  const TAStore* get_activity_store() const override { return m_tc_maker.get_activity_store(); }
+  bool resolve(TriggerCandidate& tc) override { return m_tc_maker.resolve(tc); }
+  void enable_metrics(bool enable = true) override
+  {
+    m_ta_maker.enable_metrics(enable);
+    m_tc_maker.enable_metrics(enable);
+  }
+  nlohmann::json get_metrics() const override
+  {
+    return { { "activity", m_ta_maker.get_metrics() }, { "candidate", m_tc_maker.get_metrics() } };
+  }
+
+  TAM& activity_maker() { return m_ta_maker; }
+  TCM& candidate_maker() { return m_tc_maker; }
+
+private:
+  void make_candidates(std::vector<TriggerCandidate>& output_tc)
+  {
+    for (auto& ta : m_activities)
+      m_tc_maker(std::move(ta), output_tc);
+    m_n_activities += m_activities.size();
+    m_activities.clear();
+  }
+
+  TAM m_ta_maker;
+  TCM m_tc_maker;
+  std::vector<TriggerActivity> m_activities;
+  uint64_t m_n_activities = 0;
+  timestamp_t m_candidate_delay = 8000; // Default window length of the TP window makers
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_PIPELINE_HPP_
@@ -27,10 +27,14 @@ namespace triggeralgs {
 class TriggerActivityMakerPlaneCoincidence : public TriggerActivityMaker
 {
 public:
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
   void configure(const nlohmann::json& config);
 
 private:
+  void emit_ta(std::vector<TriggerActivity>& output_ta); // Make the TA from the collection window
   TriggerActivity construct_ta(TPWindow m_current_window) const;
   uint16_t check_adjacency(TPWindow window) const; // Returns longest string of adjacent collection hits in window
 
@@ -63,11 +67,13 @@ private:
   // Channel map object, for separating TPs by the plane view they come from
   std::shared_ptr<dunedaq::detchannelmaps::TPCChannelMap> channelMap = dunedaq::detchannelmaps::make_map(m_channel_map_name);
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
   // For debugging and performance study purposes.
   void add_window_to_record(TPWindow window);
   void dump_window_record();
   void dump_tp(TriggerPrimitive const& input_tp);
   std::vector<TPWindow> m_window_record;
+#endif
 };
 } // namespace triggeralgs
 #endif // TRIGGERALGS_PLANECOINCIDENCE_TRIGGERACTIVITYMAKERPLANECOINCIDENCE_HPP_
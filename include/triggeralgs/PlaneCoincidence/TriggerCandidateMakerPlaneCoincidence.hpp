@@ -19,8 +19,12 @@ class TriggerCandidateMakerPlaneCoincidence : public TriggerCandidateMaker
 {
 
 public:
+  using TriggerCandidateMaker::operator();
+  using TriggerCandidateMaker::flush;
   // The function that gets called when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
+  void operator()(TriggerActivity&&, std::vector<TriggerCandidate>&);
+  void flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc);
   void configure(const nlohmann::json& config);
 
 private:
@@ -41,10 +45,12 @@ private:
   timestamp_t m_readout_window_ticks_after = 30000;
   int tc_number = 0;
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
   // For debugging and performance study purposes.
   void add_window_to_record(TAWindow window);
   void dump_window_record();
   std::vector<TAWindow> m_window_record;
+#endif
 };
 } // namespace triggeralgs
 #endif // TRIGGERALGS_PLANECOINCIDENCE_TRIGGERCANDIDATEMAKERPLANECOINCIDENCE_HPP_
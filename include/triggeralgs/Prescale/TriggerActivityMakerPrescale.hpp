@@ -14,11 +14,13 @@
 #include <vector>
 
 namespace triggeralgs {
-class TriggerActivityMakerPrescale : public TriggerActivityMaker
+class TriggerActivityMakerPrescale final : public TriggerActivityMaker
 {
 
 public:
+  TriggerActivityMakerPrescale() { m_metrics.set_supported(); }
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta) override;
   
   void configure(const nlohmann::json &config);
   
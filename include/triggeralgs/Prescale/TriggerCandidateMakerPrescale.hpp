@@ -14,16 +14,23 @@
 #include <vector>
 
 namespace triggeralgs {
-class TriggerCandidateMakerPrescale : public TriggerCandidateMaker
+class TriggerCandidateMakerPrescale final : public TriggerCandidateMaker
 {
 
 public:
+  TriggerCandidateMakerPrescale() { m_metrics.set_supported(); }
+  using TriggerCandidateMaker::operator();
   /// The function that gets call when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
+  /// Only the activity's header is used, so its TPs are left in the buffer
+  void operator()(const ActivityView&, std::vector<TriggerCandidate>&) override;
+  void operator()(const TriggerActivity&, OutputSink<TriggerCandidate>&) override;
+  void operator()(TriggerActivity&&, OutputSink<TriggerCandidate>&) override;
   
   void configure(const nlohmann::json &config);
   
 private:
+  void make_candidate(const TriggerActivity::TriggerActivityData& activity, OutputSink<TriggerCandidate>& cand);
 
   uint64_t m_activity_count = 0;    // NOLINT(build/unsigned)
   uint64_t m_prescale = 1;          // NOLINT(build/unsigned)
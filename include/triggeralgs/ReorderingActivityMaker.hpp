@@ -0,0 +1,52 @@
+/**
+ * @file ReorderingActivityMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_REORDERINGACTIVITYMAKER_HPP_
+#define TRIGGERALGS_REORDERINGACTIVITYMAKER_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPReorderBuffer.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Feeds the TA maker named by `maker` through a TPReorderBuffer, so that it only
+/// ever sees TPs in time_start order. TPs more than `horizon` ticks out of order are dropped.
+class ReorderingActivityMaker : public TriggerActivityMaker
+{
+public:
+  ReorderingActivityMaker() { m_metrics.set_supported(); }
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) override;
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta) override;
+  void configure(const nlohmann::json& config) override;
+  /// @brief Also turns on the counters of the wrapped maker
+  void enable_metrics(bool enable = true) override;
+  /// @brief Counts late TPs as drops, with the wrapped maker's own metrics under "maker"
+  nlohmann::json get_metrics() const override;
+
+  uint64_t get_n_late() const { return m_reorder ? m_reorder->get_n_late() : 0; }
+
+private:
+  std::unique_ptr<TriggerActivityMaker> m_maker;
+  std::unique_ptr<TPReorderBuffer> m_reorder;
+  uint64_t m_n_late_reported = 0;
+
+  // Configurable parameters.
+  std::string m_maker_name;
+  timestamp_t m_horizon = 6250;    // 100 us
+  timestamp_t m_bucket_width = 32; // 0.5 us
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_REORDERINGACTIVITYMAKER_HPP_
@@ -0,0 +1,96 @@
+/* @file: SPSCRing.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_SPSCRING_HPP_
+#define TRIGGERALGS_SPSCRING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace triggeralgs {
+
+/// @brief Bounded lock-free ring buffer for exactly one producer thread and one consumer thread.
+///
+/// The producer and consumer indices live on separate cache lines, and each side keeps a
+/// cached copy of the other side's index so it only touches the shared line when the ring
+/// looks full (or empty).
+template<typename T>
+class SPSCRing
+{
+public:
+  static constexpr size_t s_cache_line_size = 64;
+
+  /// @param capacity Rounded up to a power of two
+  explicit SPSCRing(size_t capacity)
+  {
+    size_t n_slots = 2;
+    while (n_slots < capacity)
+      n_slots <<= 1;
+    m_mask = n_slots - 1;
+    m_slots = std::make_unique<T[]>(n_slots);
+  }
+
+  SPSCRing(const SPSCRing&) = delete;
+  SPSCRing& operator=(const SPSCRing&) = delete;
+
+  /// @brief Producer side. Returns false, leaving `item` untouched, if the ring is full.
+  template<typename U>
+  bool try_push(U&& item)
+  {
+    const size_t head = m_head.value.load(std::memory_order_relaxed);
+    if (head - m_tail_cache.value == capacity()) {
+      m_tail_cache.value = m_tail.value.load(std::memory_order_acquire);
+      if (head - m_tail_cache.value == capacity())
+        return false;
+    }
+    m_slots[head & m_mask] = std::forward<U>(item);
+    m_head.value.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Consumer side. Returns false if the ring is empty.
+  bool try_pop(T& item)
+  {
+    const size_t tail = m_tail.value.load(std::memory_order_relaxed);
+    if (tail == m_head_cache.value) {
+      m_head_cache.value = m_head.value.load(std::memory_order_acquire);
+      if (tail == m_head_cache.value)
+        return false;
+    }
+    item = std::move(m_slots[tail & m_mask]);
+    m_tail.value.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief Number of items in the ring. Exact only when called from the producer or consumer.
+  size_t size() const
+  {
+    return m_head.value.load(std::memory_order_acquire) - m_tail.value.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const { return m_mask + 1; }
+
+private:
+  template<typename V>
+  struct alignas(s_cache_line_size) Padded
+  {
+    V value{};
+  };
+
+  Padded<std::atomic<size_t>> m_head; // Written by the producer
+  Padded<size_t> m_tail_cache;        // Producer's view of m_tail
+  Padded<std::atomic<size_t>> m_tail; // Written by the consumer
+  Padded<size_t> m_head_cache;        // Consumer's view of m_head
+  size_t m_mask = 0;
+  std::unique_ptr<T[]> m_slots;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_SPSCRING_HPP_
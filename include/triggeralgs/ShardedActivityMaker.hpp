@@ -0,0 +1,113 @@
+/**
+ * @file ShardedActivityMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_SHARDEDACTIVITYMAKER_HPP_
+#define TRIGGERALGS_SHARDEDACTIVITYMAKER_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/SPSCRing.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/WaitStrategy.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Runs one TA algorithm over several detector units in parallel.
+///
+/// Builds `n_shards` instances of the TA maker named by `maker` (configured with
+/// `maker_config`), each driven by its own worker thread. TPs are routed to a shard by
+/// `detid`, or by the optional `channel_ranges` list of inclusive [first, last] channel
+/// ranges (one per shard), and handed over on SPSC rings.
+///
+/// Each TA is tagged with the time_start of the TP that made its maker emit it. TAs from all
+/// shards are merged on that tag, and are only released once no shard can still emit an
+/// earlier one, so the output is in the same order a single maker would give for each unit.
+/// operator() and flush() must be called from a single thread. An idle worker spins briefly
+/// and then parks until it is given a TP, so quiet shards don't hold on to a core.
+///
+/// The optional `affinity` list gives the CPU cores for each shard's worker. Each worker pins
+/// itself and then builds its own maker and rings, so their memory is first touched, and so
+/// allocated, on the NUMA node of those cores.
+class ShardedActivityMaker : public TriggerActivityMaker
+{
+public:
+  ShardedActivityMaker() { m_metrics.set_supported(); }
+  ~ShardedActivityMaker();
+
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) override;
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta) override;
+  void configure(const nlohmann::json& config) override;
+  /// @brief Also turns on the counters of every shard's maker
+  void enable_metrics(bool enable = true) override;
+  /// @brief Counts unrouted TPs as drops, with each shard's maker's own metrics under "shards"
+  nlohmann::json get_metrics() const override;
+
+  /// Number of TPs that matched none of the channel ranges and were dropped
+  uint64_t get_n_unrouted() const { return m_n_unrouted; }
+
+private:
+  struct TaggedActivity
+  {
+    timestamp_t tag;
+    TriggerActivity ta;
+  };
+
+  struct Shard
+  {
+    Shard(size_t ring_capacity)
+      : input(ring_capacity)
+      , output(ring_capacity)
+    {}
+
+    std::unique_ptr<TriggerActivityMaker> maker;
+    SPSCRing<TriggerPrimitive> input;
+    SPSCRing<TaggedActivity> output;
+    WaitStrategy input_wait{ WaitMode::kPark };  // The worker waits here for TPs
+    WaitStrategy output_wait{ WaitMode::kPark }; // and here for room for its TAs
+
+    // Written by the worker.
+    std::atomic<timestamp_t> watermark{ 0 }; // time_start of the last TP processed
+    std::atomic<uint64_t> n_processed{ 0 };
+
+    // Only touched by the calling thread.
+    uint64_t n_dispatched = 0;
+    std::deque<TaggedActivity> pending;
+  };
+
+  void run_worker(size_t index, nlohmann::json maker_config);
+  void stop_workers();
+  size_t route(const TriggerPrimitive& input_tp) const;
+  void collect(std::vector<TriggerActivity>& output_ta, bool drain_all);
+  void drain_outputs();
+
+  std::vector<std::unique_ptr<Shard>> m_shards; // Each built by its worker
+  std::vector<std::thread> m_workers;
+  std::atomic<size_t> m_n_started{ 0 };
+  std::atomic<bool> m_build_failed{ false };
+  std::vector<std::pair<channel_t, channel_t>> m_channel_ranges; // Index is the shard number
+  std::atomic<bool> m_running{ false };
+  timestamp_t m_last_dispatched = 0;
+  uint64_t m_n_unrouted = 0;
+
+  // Configurable parameters.
+  std::string m_maker_name;
+  size_t m_n_shards = 1;
+  size_t m_ring_capacity = 4096;
+  std::vector<std::vector<int>> m_affinity; // Index is the shard number
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_SHARDEDACTIVITYMAKER_HPP_
@@ -47,9 +47,19 @@ class TriggerActivityMakerSupernova : public TriggerActivityMaker
   }
 
 public:
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) override;
 
-  void flush(timestamp_t, std::vector<TriggerActivity>& tas) override { tas.push_back(MakeTriggerActivity()); }
+  void flush(timestamp_t until, std::vector<TriggerActivity>& tas) override
+  {
+    // Any later TP on a nearby channel still joins the activity, however late it is, so only
+    // the end of the stream closes it. Start afresh after, so it isn't emitted again.
+    if (m_time_start == 0 || until != std::numeric_limits<timestamp_t>::max())
+      return;
+    tas.push_back(MakeTriggerActivity());
+    m_time_start = 0;
+  }
 
 protected:
   timestamp_diff_t m_time_tolerance =
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <atomic>
 #include <limits>
+#include <utility>
 #include <vector>
 
 namespace triggeralgs {
@@ -24,11 +25,17 @@ class TriggerCandidateMakerSupernova : public TriggerCandidateMaker
   /// if the number of activities exceeds that.
 
 public:
+  using TriggerCandidateMaker::operator();
   /// The function that gets call when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
 
 protected:
+  /// Activities in the time window, ordered by time_start. The window is used as a deque:
+  /// old activities are only ever flushed from the front, by moving m_activity_begin past
+  /// them, so the buffer can be handed over to a TC by move.
   std::vector<TriggerActivity::TriggerActivityData> m_activity;
+  /// Index of the first activity still in the time window
+  size_t m_activity_begin = 0;
   /// Slinding time window to count activities
   std::atomic<int64_t> m_time_window = { 500'000'000 };
   /// Minimum number of activities in the time window to issue a trigger
@@ -36,13 +43,43 @@ protected:
   /// Minimum number of primities in an activity
   std::atomic<uint16_t> m_hit_threshold = { 2 }; // NOLINT(build/unsigned)
 
+  /// Number of activities currently in the time window
+  size_t ActivityCount() const { return m_activity.size() - m_activity_begin; }
+
+  /// this function adds an activity, keeping the window ordered by time_start. Activities
+  /// normally arrive in time order, so the search only looks past the last few entries.
+  void AddActivity(const TriggerActivity::TriggerActivityData& activity)
+  {
+    auto it = m_activity.end();
+    while (it != m_activity.begin() + m_activity_begin && (it - 1)->time_start > activity.time_start)
+      --it;
+    m_activity.insert(it, activity);
+  }
+
   /// this function gets rid of the old activities
   void FlushOldActivity(timestamp_t time_now)
   {
     timestamp_diff_t how_far = time_now - m_time_window;
-    auto end = std::remove_if(
-                              m_activity.begin(), m_activity.end(), [how_far, this](auto& c) -> bool { return (static_cast<dunedaq::trgdataformats::timestamp_diff_t>(c.time_start) < how_far); });
-    m_activity.erase(end, m_activity.end());
+    while (m_activity_begin < m_activity.size() &&
+           static_cast<dunedaq::trgdataformats::timestamp_diff_t>(m_activity[m_activity_begin].time_start) < how_far)
+      ++m_activity_begin;
+
+    // Give the flushed slots back once they make up half of the buffer, so this stays
+    // amortised O(1) per activity.
+    if (m_activity_begin > 0 && 2 * m_activity_begin >= m_activity.size()) {
+      m_activity.erase(m_activity.begin(), m_activity.begin() + m_activity_begin);
+      m_activity_begin = 0;
+    }
+  }
+
+  /// this function hands the activities in the time window over, leaving the window empty
+  std::vector<TriggerActivity::TriggerActivityData> TakeActivity()
+  {
+    m_activity.erase(m_activity.begin(), m_activity.begin() + m_activity_begin);
+    m_activity_begin = 0;
+    std::vector<TriggerActivity::TriggerActivityData> activity = std::move(m_activity);
+    m_activity.clear();
+    return activity;
   }
 };
 
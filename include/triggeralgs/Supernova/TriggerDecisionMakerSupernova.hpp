@@ -23,6 +23,7 @@ class TriggerDecisionMakerSupernova : public TriggerDecisionMaker
   /// This decision maker just spits out the trigger candidates
 
 public:
+  using TriggerDecisionMaker::operator();
   /// The function that returns the final trigger decision (copy of a candidate for now)
   void operator()(const TriggerCandidate&, std::vector<TriggerDecision>&);
 
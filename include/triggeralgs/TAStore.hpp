@@ -0,0 +1,60 @@
+/* @file: TAStore.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_TASTORE_HPP_
+#define TRIGGERALGS_TASTORE_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivity.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidate.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief The headers of the last `capacity` TAs a stage has seen, by sequence number.
+///
+/// A TC maker configured with `reference_inputs` adds each TA here once as it arrives and
+/// gives its TCs ActivityRefs into the store instead of copies of every TA in the window, so
+/// overlapping TCs share one copy of each TA. resolve() fills in a TC's inputs from its refs
+/// when it is about to be serialized. The store is a ring: a TA is overwritten `capacity` TAs
+/// after it was added, so TCs have to be resolved before then. With set_retention() the ring
+/// grows instead of overwriting a TA that is still recent, so however many TAs a TC window of
+/// that length holds, its refs can be resolved as it is emitted.
+class TAStore
+{
+public:
+  explicit TAStore(size_t capacity = 1024);
+
+  ActivityRef add(const TriggerActivity::TriggerActivityData& activity);
+
+  /// @brief The TA `ref` refers to, or nullptr if it has been overwritten
+  const TriggerActivity::TriggerActivityData* find(const ActivityRef& ref) const;
+
+  /// @brief Append the TAs `tc` refers to to its inputs and clear its refs. False if any of
+  /// them have been overwritten, in which case those are left out.
+  bool resolve(TriggerCandidate& tc) const;
+
+  void set_capacity(size_t capacity);
+  /// @brief Keep every TA whose time_start is less than `ticks` before that of the TA being
+  /// added, growing the ring if need be. 0 (the default) keeps the capacity fixed.
+  void set_retention(timestamp_t ticks) { m_retention = ticks; }
+  size_t capacity() const { return m_capacity; }
+  uint64_t get_n_added() const { return m_next_sequence; }
+
+private:
+  std::vector<TriggerActivity::TriggerActivityData> m_ring;
+  size_t m_capacity;
+  uint64_t m_next_sequence = 0;
+  uint64_t m_first_sequence = 0; // Of the oldest TA kept when the ring last grew
+  timestamp_t m_retention = 0;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_TASTORE_HPP_
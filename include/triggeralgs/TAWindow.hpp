@@ -9,6 +9,7 @@
 #define TRIGGERALGS_TAWINDOW_HPP_
 
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivity.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidate.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
 
 #include <ostream>
@@ -27,11 +28,14 @@ public:
   /// list time ordered by time_start. Preserving time order makes moving easier.
   /// @param input_ta
   void add(const TriggerActivity& input_ta);
+  /// @brief As add(), taking ownership of the TA and its TP list instead of copying them.
+  /// `ref` is kept in refs, alongside the TA in inputs.
+  void add(TriggerActivity&& input_ta, const ActivityRef& ref = ActivityRef());
 
   /// @brief Clear all inputs
   void clear();
 
-  uint16_t n_channels_hit() { return channel_states.size(); };
+  uint16_t n_channels_hit() { return n_channels; };
 
   /// @brief 
   /// Find all of the TAs in the window that need to be removed
@@ -42,17 +46,26 @@ public:
   /// @param input_ta 
   /// @param window_length 
   void move(TriggerActivity const& input_ta, timestamp_t const& window_length);
+  void move(TriggerActivity&& input_ta, timestamp_t const& window_length, const ActivityRef& ref = ActivityRef());
 
   /// @brief Reset window content on the input
   /// @param input_ta 
   void reset(TriggerActivity const& input_ta);
+  void reset(TriggerActivity&& input_ta, const ActivityRef& ref = ActivityRef());
 
   friend std::ostream& operator<<(std::ostream& os, const TAWindow& window);
 
   timestamp_t time_start;
   uint64_t adc_integral;
+  // Hits per channel, kept at zero rather than erased once a channel has none left in the
+  // window, as in TPWindow; n_channels counts the channels with hits.
   std::unordered_map<channel_t, uint16_t> channel_states;
+  uint16_t n_channels = 0;
   std::vector<TriggerActivity> inputs;
+  std::vector<ActivityRef> refs; // Where each of inputs is in a TAStore, if it is in one
+
+private:
+  void clear_channel_states();
 };
 
 } // namespace triggeralgs
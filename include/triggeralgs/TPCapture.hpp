@@ -0,0 +1,115 @@
+/* @file: TPCapture.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_TPCAPTURE_HPP_
+#define TRIGGERALGS_TPCAPTURE_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerPrimitive.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Where a block of a TP capture is, and which TPs it holds.
+struct TPCaptureBlockInfo
+{
+  uint64_t offset;        // Of the block header from the start of the file
+  uint32_t n_tps;
+  uint32_t nbytes;        // Of the encoded columns following the header
+  timestamp_t time_first; // time_start of the first TP
+  timestamp_t time_max;   // Largest time_start in the block
+};
+
+/// @brief Writes a TP stream to a file in compressed columnar blocks.
+///
+/// The file is a header, then blocks of `block_size` TPs, then an index of the blocks and a
+/// trailer pointing at it. Within a block each TP field is stored as its own column of
+/// varints: time_start and channel as zigzagged differences from the previous TP, time_peak
+/// relative to time_start, the other counts as they are, and detid, type, algorithm, version
+/// and flag, which hardly ever change, as runs of equal values. A stream in time order takes
+/// around 9 bytes per TP.
+///
+/// TPs are encoded a block at a time from a buffer that keeps its capacity, so nothing is
+/// allocated per TP. close() (or the destructor) writes the last block and the index; a file
+/// that was never closed can still be read, up to its last complete block.
+class TPCaptureWriter
+{
+public:
+  TPCaptureWriter() = default;
+  TPCaptureWriter(const TPCaptureWriter&) = delete;
+  TPCaptureWriter& operator=(const TPCaptureWriter&) = delete;
+  ~TPCaptureWriter() { close(); }
+
+  bool open(const std::string& path, uint32_t block_size = 4096);
+  void write(const TriggerPrimitive& input_tp)
+  {
+    m_block.push_back(input_tp);
+    if (m_block.size() >= m_block_size)
+      write_block();
+  }
+  bool close();
+
+  bool is_good() const { return m_file.good(); }
+  uint64_t get_n_tps() const { return m_n_tps; }
+  uint64_t get_nbytes() const { return m_offset; }
+
+private:
+  void write_block();
+
+  std::ofstream m_file;
+  uint32_t m_block_size = 4096;
+  std::vector<TriggerPrimitive> m_block;
+  std::vector<uint8_t> m_encoded;
+  std::vector<TPCaptureBlockInfo> m_index;
+  uint64_t m_offset = 0;
+  uint64_t m_n_tps = 0;
+};
+
+/// @brief Reads a file written by TPCaptureWriter a block at a time.
+///
+/// open() loads the block index, or rebuilds it from the block headers when the writer didn't
+/// get to close the file. read_block() decodes a block into a vector the caller keeps, so
+/// replaying a capture allocates nothing once the vector has grown to the block size. Eg
+///
+///   TPCaptureReader reader;
+///   std::vector<TriggerPrimitive> tps;
+///   if (reader.open(path))
+///     for (size_t i = reader.find_block(start); reader.read_block(i, tps); ++i) ...
+class TPCaptureReader
+{
+public:
+  bool open(const std::string& path);
+
+  const std::vector<TPCaptureBlockInfo>& get_index() const { return m_index; }
+  size_t get_n_blocks() const { return m_index.size(); }
+  uint64_t get_n_tps() const { return m_n_tps; }
+
+  /// @brief First block that can hold a TP with time_start at or after `time`
+  size_t find_block(timestamp_t time) const;
+
+  /// @brief Replace the contents of `tps` with block `index`. False past the last block, or
+  /// if the block can't be read or is corrupt.
+  bool read_block(size_t index, std::vector<TriggerPrimitive>& tps);
+
+private:
+  bool read_index();
+  bool scan_blocks();
+
+  std::ifstream m_file;
+  std::vector<TPCaptureBlockInfo> m_index;
+  std::vector<timestamp_t> m_time_max_so_far; // Running maximum of time_max over the blocks
+  std::vector<uint8_t> m_encoded;
+  uint64_t m_n_tps = 0;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_TPCAPTURE_HPP_
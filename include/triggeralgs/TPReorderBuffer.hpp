@@ -0,0 +1,141 @@
+/* @file: TPReorderBuffer.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_TPREORDERBUFFER_HPP_
+#define TRIGGERALGS_TPREORDERBUFFER_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerPrimitive.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Puts a slightly out-of-order TP stream back into time_start order.
+///
+/// TPs are held in a ring of time buckets, each `bucket_width` ticks wide, until the watermark
+/// (the latest time_start seen minus `horizon`) has passed the end of their bucket. The bucket
+/// is then sorted and released. A TP arriving after its bucket was released is dropped and
+/// counted as late, so the output is always in order.
+///
+/// Buckets keep their capacity when cleared, so once warmed up nothing is allocated per TP.
+/// `sink` is anything callable with a `const TriggerPrimitive&`.
+class TPReorderBuffer
+{
+public:
+  TPReorderBuffer(timestamp_t horizon, timestamp_t bucket_width);
+
+  template<typename Sink>
+  void add(const TriggerPrimitive& input_tp, Sink&& sink);
+
+  /// @brief Release every held TP
+  template<typename Sink>
+  void flush(Sink&& sink);
+
+  /// @brief Release the TPs in every bucket ending at or before `until`, for when no TP
+  /// earlier than `until` can arrive any more
+  template<typename Sink>
+  void release_until(timestamp_t until, Sink&& sink);
+
+  /// Every TP before this time has been released, or will be dropped as late
+  timestamp_t released_until() const { return m_base_bucket * m_bucket_width; }
+
+  size_t size() const { return m_n_held; }
+  uint64_t get_n_late() const { return m_n_late; }
+
+private:
+  std::vector<TriggerPrimitive>& bucket(uint64_t index) { return m_buckets[index % m_buckets.size()]; }
+
+  template<typename Sink>
+  void release_front(Sink&& sink);
+
+  std::vector<std::vector<TriggerPrimitive>> m_buckets;
+  timestamp_t m_horizon;
+  timestamp_t m_bucket_width;
+  uint64_t m_base_bucket = 0; // Index of the oldest unreleased bucket
+  timestamp_t m_newest = 0;
+  bool m_started = false;
+  size_t m_n_held = 0;
+  uint64_t m_n_late = 0;
+};
+
+template<typename Sink>
+void
+TPReorderBuffer::add(const TriggerPrimitive& input_tp, Sink&& sink)
+{
+  uint64_t index = input_tp.time_start / m_bucket_width;
+  if (!m_started) {
+    // TPs up to a horizon earlier than the first one can still arrive.
+    m_base_bucket = input_tp.time_start > m_horizon ? (input_tp.time_start - m_horizon) / m_bucket_width : 0;
+    m_started = true;
+  }
+  m_newest = std::max(m_newest, input_tp.time_start);
+  timestamp_t watermark = m_newest > m_horizon ? m_newest - m_horizon : 0;
+
+  // Release before inserting, so the new TP never lands on a bucket that is still in use.
+  while ((m_base_bucket + 1) * m_bucket_width <= watermark) {
+    if (m_n_held == 0) {
+      // Skip straight over gaps in the data rather than walking empty buckets.
+      m_base_bucket = watermark / m_bucket_width;
+      break;
+    }
+    release_front(sink);
+  }
+
+  if (index < m_base_bucket) {
+    m_n_late++;
+    return;
+  }
+  bucket(index).push_back(input_tp);
+  m_n_held++;
+}
+
+template<typename Sink>
+void
+TPReorderBuffer::flush(Sink&& sink)
+{
+  while (m_n_held > 0)
+    release_front(sink);
+}
+
+template<typename Sink>
+void
+TPReorderBuffer::release_until(timestamp_t until, Sink&& sink)
+{
+  if (!m_started)
+    return;
+
+  while ((m_base_bucket + 1) * m_bucket_width <= until) {
+    if (m_n_held == 0) {
+      m_base_bucket = std::max<uint64_t>(m_base_bucket, until / m_bucket_width);
+      break;
+    }
+    release_front(sink);
+  }
+}
+
+template<typename Sink>
+void
+TPReorderBuffer::release_front(Sink&& sink)
+{
+  auto& front = bucket(m_base_bucket);
+  std::stable_sort(front.begin(), front.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+  for (const auto& tp : front)
+    sink(tp);
+
+  m_n_held -= front.size();
+  front.clear();
+  m_base_bucket++;
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_TPREORDERBUFFER_HPP_
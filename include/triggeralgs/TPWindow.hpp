@@ -36,8 +36,15 @@ public:
 
   timestamp_t time_start;
   uint32_t adc_integral;
+  // Hits per channel. A channel keeps its entry, at zero, once it has no hits left in the
+  // window, so that the map stops allocating once every channel has been seen; n_channels
+  // counts the channels with hits.
   std::unordered_map<channel_t, uint16_t> channel_states;
+  uint16_t n_channels = 0;
   std::vector<TriggerPrimitive> inputs;
+
+private:
+  void clear_channel_states();
 };
 } // namespace triggeralgs
 
@@ -0,0 +1,155 @@
+/* @file: TPZipper.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_TPZIPPER_HPP_
+#define TRIGGERALGS_TPZIPPER_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerPrimitive.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Merges the TP streams of several links into one time-ordered stream.
+///
+/// Each link must deliver its own TPs in time_start order. A link's watermark is the latest
+/// time it has reported, either through a TP or a heartbeat; a TP is emitted once every link's
+/// watermark has reached it. A link whose watermark falls more than `max_latency` behind the
+/// newest time seen on any link is declared late and no longer holds back the output. TPs that
+/// then arrive before the last emitted time are dropped and counted.
+///
+/// Per-link queues are fixed-size rings allocated in the constructor, so nothing is
+/// allocated per TP. If a link's queue fills up, the oldest TPs are emitted straight away.
+///
+/// `sink` is anything callable with a `const TriggerPrimitive&`, eg
+/// `[&](const TriggerPrimitive& tp) { maker(tp, tas); }`.
+class TPZipper
+{
+public:
+  TPZipper(size_t n_links, timestamp_t max_latency, size_t link_capacity = 1024);
+
+  template<typename Sink>
+  void add(size_t link, const TriggerPrimitive& input_tp, Sink&& sink);
+
+  /// @brief Tell the zipper that `link` will send no TP earlier than `time`
+  template<typename Sink>
+  void heartbeat(size_t link, timestamp_t time, Sink&& sink);
+
+  /// @brief Emit every queued TP, regardless of watermarks
+  template<typename Sink>
+  void flush(Sink&& sink);
+
+  size_t n_links() const { return m_links.size(); }
+  bool is_late(size_t link) const;
+
+  uint64_t get_n_late() const { return m_n_late; }     // TPs dropped for arriving too late
+  uint64_t get_n_forced() const { return m_n_forced; } // TPs emitted early on a full queue
+
+private:
+  struct Link
+  {
+    std::vector<TriggerPrimitive> ring;
+    size_t head = 0;
+    size_t size = 0;
+    timestamp_t watermark = 0;
+  };
+
+  // Heap entry for the TP at the front of a link's queue.
+  struct Head
+  {
+    timestamp_t time;
+    size_t link;
+    bool operator<(const Head& other) const { return time > other.time; } // Min-heap
+  };
+
+  bool push(size_t link, const TriggerPrimitive& input_tp);
+  void advance_watermark(size_t link, timestamp_t time);
+  timestamp_t safe_time() const;
+
+  template<typename Sink>
+  void emit_until(timestamp_t until, Sink&& sink);
+  template<typename Sink>
+  void emit_front(Sink&& sink);
+
+  std::vector<Link> m_links;
+  std::vector<Head> m_heap; // One entry per non-empty link
+  timestamp_t m_max_latency;
+  timestamp_t m_newest = 0;       // Latest watermark of any link
+  timestamp_t m_min_watermark = 0; // Earliest watermark of any link
+  timestamp_t m_last_emitted = 0;
+  uint64_t m_n_late = 0;
+  uint64_t m_n_forced = 0;
+};
+
+template<typename Sink>
+void
+TPZipper::add(size_t link, const TriggerPrimitive& input_tp, Sink&& sink)
+{
+  if (input_tp.time_start < m_last_emitted) {
+    m_n_late++;
+    return;
+  }
+
+  // Make room by emitting early rather than blocking on a link that will never catch up.
+  while (!push(link, input_tp)) {
+    m_n_forced++;
+    emit_front(sink);
+  }
+  advance_watermark(link, input_tp.time_start);
+  emit_until(safe_time(), sink);
+}
+
+template<typename Sink>
+void
+TPZipper::heartbeat(size_t link, timestamp_t time, Sink&& sink)
+{
+  advance_watermark(link, time);
+  emit_until(safe_time(), sink);
+}
+
+template<typename Sink>
+void
+TPZipper::flush(Sink&& sink)
+{
+  while (!m_heap.empty())
+    emit_front(sink);
+}
+
+template<typename Sink>
+void
+TPZipper::emit_until(timestamp_t until, Sink&& sink)
+{
+  while (!m_heap.empty() && m_heap.front().time <= until)
+    emit_front(sink);
+}
+
+template<typename Sink>
+void
+TPZipper::emit_front(Sink&& sink)
+{
+  std::pop_heap(m_heap.begin(), m_heap.end());
+  Head& top = m_heap.back();
+  Link& link = m_links[top.link];
+
+  m_last_emitted = top.time;
+  sink(static_cast<const TriggerPrimitive&>(link.ring[link.head]));
+  link.head = (link.head + 1) % link.ring.size();
+
+  if (--link.size == 0) {
+    m_heap.pop_back();
+  } else {
+    top.time = link.ring[link.head].time_start;
+    std::push_heap(m_heap.begin(), m_heap.end());
+  }
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_TPZIPPER_HPP_
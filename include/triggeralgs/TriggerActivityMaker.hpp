@@ -11,6 +11,8 @@
 
 //#include "dunetrigger/triggeralgs/include/triggeralgs/Issues.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Logging.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/MakerMetrics.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/OutputSink.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivity.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerPrimitive.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
@@ -18,6 +20,7 @@
 #include <atomic>
 #include <chrono>
 #include <nlohmann/json.hpp>
+#include <utility>
 #include <vector>
 
 namespace triggeralgs {
@@ -27,8 +30,45 @@ class TriggerActivityMaker
 public:
   virtual ~TriggerActivityMaker() = default;
   virtual void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) = 0;
+  /// @brief Called when no more TPs with time_start < `until` will arrive. Emits any TA that
+  /// the next TP would have made, without waiting for it. Makers that decide on every input
+  /// have nothing held back, and keep this default. `until` of
+  /// std::numeric_limits<timestamp_t>::max() is the end of the stream.
   virtual void flush(timestamp_t /* until */, std::vector<TriggerActivity>&) {}
   virtual void configure(const nlohmann::json&) {}
+
+  /// @brief As the vector versions, but moving each TA into `output_ta` as it is made. Makers
+  /// that emit into a sink override these and turn their vector versions into adapters over a
+  /// VectorSink. The defaults go the other way, through a buffer that keeps its capacity.
+  virtual void operator()(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta)
+  {
+    (*this)(input_tp, m_sink_buffer);
+    drain_sink_buffer(output_ta);
+  }
+  virtual void flush(timestamp_t until, OutputSink<TriggerActivity>& output_ta)
+  {
+    flush(until, m_sink_buffer);
+    drain_sink_buffer(output_ta);
+  }
+
+  /// @brief Turn the counters reported by get_metrics() on or off. Call before the maker starts.
+  virtual void enable_metrics(bool enable = true) { m_metrics.set_enabled(enable); }
+  /// @brief The maker's MakerMetrics counters so far. Safe to call from another thread while
+  /// the maker runs.
+  virtual nlohmann::json get_metrics() const { return m_metrics.get_json(); }
+
+protected:
+  MakerMetrics m_metrics;
+
+private:
+  void drain_sink_buffer(OutputSink<TriggerActivity>& output_ta)
+  {
+    for (auto& ta : m_sink_buffer)
+      output_ta.emit(std::move(ta));
+    m_sink_buffer.clear();
+  }
+
+  std::vector<TriggerActivity> m_sink_buffer;
 };
 
 } // namespace triggeralgs
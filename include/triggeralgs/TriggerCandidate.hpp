@@ -11,14 +11,27 @@
 
 #include "detdataformats/trigger/TriggerActivityData.hpp"
 #include "detdataformats/trigger/TriggerCandidateData.hpp"
+#include "detdataformats/trigger/Types.hpp"
 
+#include <cstdint>
 #include <vector>
 
 namespace triggeralgs {
 
+/// @brief A TA kept in a TAStore, by its sequence number there
+struct ActivityRef
+{
+  uint64_t sequence = 0;
+  dunedaq::trgdataformats::timestamp_t time_start = 0;
+  dunedaq::trgdataformats::timestamp_t time_end = 0;
+};
+
 struct TriggerCandidate : public dunedaq::trgdataformats::TriggerCandidateData
 {
   std::vector<dunedaq::trgdataformats::TriggerActivityData> inputs;
+  // Set instead of inputs by TC makers configured with reference_inputs. TAStore::resolve()
+  // turns them into inputs before the TC is serialized.
+  std::vector<ActivityRef> input_refs;
 };
 
 } // namespace triggeralgs
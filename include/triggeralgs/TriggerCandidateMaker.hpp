@@ -11,13 +11,18 @@
 
 #include "dunetrigger/triggeralgs/include/triggeralgs/Issues.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Logging.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/MakerMetrics.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/OutputSink.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TAStore.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivity.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidate.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerObjectOverlay.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
 
 #include <atomic>
 #include <chrono>
 #include <nlohmann/json.hpp>
+#include <utility>
 #include <vector>
 
 namespace triggeralgs {
@@ -27,8 +32,78 @@ class TriggerCandidateMaker
 public:
   virtual ~TriggerCandidateMaker() = default;
   virtual void operator()(const TriggerActivity& input_ta, std::vector<TriggerCandidate>& output_tc) = 0;
+  /// @brief As above, for a TA the caller no longer needs. Makers that keep their input TAs
+  /// override this to take the TA, TP list included, without copying it.
+  virtual void operator()(TriggerActivity&& input_ta, std::vector<TriggerCandidate>& output_tc)
+  {
+    (*this)(static_cast<const TriggerActivity&>(input_ta), output_tc);
+  }
+  /// @brief As above, for a TA still in its overlay buffer. Makers that only need the TA's
+  /// data header override this to skip copying its TPs into a TriggerActivity. The default
+  /// drops views that overrun their buffer.
+  virtual void operator()(const ActivityView& input_ta, std::vector<TriggerCandidate>& output_tc)
+  {
+    if (!input_ta.is_valid()) {
+      m_metrics.count_drops();
+      return;
+    }
+    (*this)(input_ta.materialize(), output_tc);
+  }
+  /// @brief Called when no more TAs with time_start < `until` will arrive. Emits any TC that
+  /// the next TA would have made, without waiting for it.
   virtual void flush(timestamp_t /* until */, std::vector<TriggerCandidate>& /* output_tc */) {}
   virtual void configure(const nlohmann::json&) {}
+  /// @brief The store that this maker's TCs' input_refs point into, or nullptr if its TCs
+  /// always carry their inputs. Resolve TCs with it before serializing them.
+  virtual const TAStore* get_activity_store() const { return nullptr; }
+  /// @brief Fill in `tc`'s inputs from its input_refs with get_activity_store(). If any of the
+  /// TAs had been overwritten, they are left out, the TC is counted as a drop and this returns
+  /// false. Call it from the maker's own thread, which is the one that writes the metrics.
+  bool resolve(TriggerCandidate& tc)
+  {
+    const TAStore* store = get_activity_store();
+    if (!store || store->resolve(tc))
+      return true;
+    m_metrics.count_drops();
+    return false;
+  }
+
+  /// @brief As the vector versions, but moving each TC into `output_tc` as it is made. See
+  /// TriggerActivityMaker.
+  virtual void operator()(const TriggerActivity& input_ta, OutputSink<TriggerCandidate>& output_tc)
+  {
+    (*this)(input_ta, m_sink_buffer);
+    drain_sink_buffer(output_tc);
+  }
+  virtual void operator()(TriggerActivity&& input_ta, OutputSink<TriggerCandidate>& output_tc)
+  {
+    (*this)(std::move(input_ta), m_sink_buffer);
+    drain_sink_buffer(output_tc);
+  }
+  virtual void flush(timestamp_t until, OutputSink<TriggerCandidate>& output_tc)
+  {
+    flush(until, m_sink_buffer);
+    drain_sink_buffer(output_tc);
+  }
+
+  /// @brief Turn the counters reported by get_metrics() on or off. Call before the maker starts.
+  virtual void enable_metrics(bool enable = true) { m_metrics.set_enabled(enable); }
+  /// @brief The maker's MakerMetrics counters so far. Safe to call from another thread while
+  /// the maker runs.
+  virtual nlohmann::json get_metrics() const { return m_metrics.get_json(); }
+
+protected:
+  MakerMetrics m_metrics;
+
+private:
+  void drain_sink_buffer(OutputSink<TriggerCandidate>& output_tc)
+  {
+    for (auto& tc : m_sink_buffer)
+      output_tc.emit(std::move(tc));
+    m_sink_buffer.clear();
+  }
+
+  std::vector<TriggerCandidate> m_sink_buffer;
 };
 
 } // namespace triggeralgs
@@ -0,0 +1,27 @@
+/* @file: TriggerDecisionFactory.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2023.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_TRIGGER_DECISION_FACTORY_HPP_
+#define TRIGGERALGS_TRIGGER_DECISION_FACTORY_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerDecisionMaker.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/AbstractFactory.hpp"
+
+#define REGISTER_TRIGGER_DECISION_MAKER(tdm_name, tdm_class)                                                                                      \
+  static struct tdm_class##Registrar {                                                                                                            \
+    tdm_class##Registrar() {                                                                                                                      \
+      TriggerDecisionFactory::register_creator(tdm_name, []() -> std::unique_ptr<TriggerDecisionMaker> {return std::make_unique<tdm_class>();});   \
+    }                                                                                                                                             \
+  } tdm_class##_registrar;
+
+namespace triggeralgs {
+
+class TriggerDecisionFactory : public AbstractFactory<TriggerDecisionMaker> {};
+
+} /* namespace triggeralgs */
+
+#endif // TRIGGERALGS_TRIGGER_DECISION_FACTORY_HPP_
@@ -11,8 +11,10 @@
 
 #include "dunetrigger/triggeralgs/include/triggeralgs/Issues.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Logging.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/MakerMetrics.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidate.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerDecision.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerObjectOverlay.hpp"
 
 #include <atomic>
 #include <chrono>
@@ -26,8 +28,30 @@ class TriggerDecisionMaker
 public:
   virtual ~TriggerDecisionMaker() = default;
   virtual void operator()(const TriggerCandidate& input_tc, std::vector<TriggerDecision>& output_tds) = 0;
+  /// @brief As above, for a TC still in its overlay buffer. The default copies it into a
+  /// TriggerCandidate first, and drops views that overrun their buffer.
+  virtual void operator()(const CandidateView& input_tc, std::vector<TriggerDecision>& output_tds)
+  {
+    if (!input_tc.is_valid()) {
+      m_metrics.count_drops();
+      return;
+    }
+    (*this)(input_tc.materialize(), output_tds);
+  }
   virtual void flush(std::vector<TriggerDecision>&) {}
+  /// @brief Called when no more TCs with time_candidate < `until` will arrive. Emits any TD
+  /// that would be released by then, without waiting for the next TC.
+  virtual void flush(timestamp_t /* until */, std::vector<TriggerDecision>&) {}
   virtual void configure(const nlohmann::json&) {}
+
+  /// @brief Turn the counters reported by get_metrics() on or off. Call before the maker starts.
+  virtual void enable_metrics(bool enable = true) { m_metrics.set_enabled(enable); }
+  /// @brief The maker's MakerMetrics counters so far. Safe to call from another thread while
+  /// the maker runs.
+  virtual nlohmann::json get_metrics() const { return m_metrics.get_json(); }
+
+protected:
+  MakerMetrics m_metrics;
 };
 
 } // namespace triggeralgs
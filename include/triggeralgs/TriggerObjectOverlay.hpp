@@ -16,6 +16,14 @@
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerPrimitive.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivity.hpp"
 #include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidate.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TAStore.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
 
 namespace triggeralgs {
 
@@ -45,6 +53,22 @@ struct TypeToOverlayType<TriggerCandidate>
   using data_t = dunedaq::trgdataformats::TriggerCandidateData;
 };
 
+// The number of inputs `object` holds as ActivityRefs rather than copies.
+// Only a TC made with reference_inputs has any, and they aren't written to
+// an overlay: resolve it with TAStore::resolve() first, or use the
+// TAStore overloads of write_overlay() and get_overlay_nbytes() below
+inline size_t
+get_n_input_refs(const TriggerActivity&)
+{
+  return 0;
+}
+
+inline size_t
+get_n_input_refs(const TriggerCandidate& candidate)
+{
+  return candidate.input_refs.size();
+}
+
 // Populate a TriggerObjectOverlay in `buffer`, created from
 // `object`. The necessary size for the buffer can be found with
 // `get_overlay_nbytes()`
@@ -53,6 +77,7 @@ template<class Object, class Overlay = typename TypeToOverlayType<Object>::overl
 void
 write_overlay(const Object& object, void* buffer)
 {
+  assert(get_n_input_refs(object) == 0);
   Overlay* overlay = reinterpret_cast<Overlay*>(buffer);
   overlay->data = static_cast<Data>(object);
   overlay->n_inputs = object.inputs.size();
@@ -70,9 +95,41 @@ get_overlay_nbytes(const Object& object)
   // Need to check that this is actually right: what does sizeof
   // return when the class contains a flexible array member? Seems to
   // work in unit tests, so probably this is right
+  assert(get_n_input_refs(object) == 0);
   return sizeof(Overlay) + object.inputs.size() * sizeof(typename Overlay::input_t);
 }
 
+// As above for a TC whose inputs are partly or wholly ActivityRefs into
+// `store`, writing the TAs they refer to after its own inputs, so the TC
+// doesn't have to be resolved (and its TAs copied) first. Refs to TAs that
+// have been overwritten in the store are left out, as in TAStore::resolve()
+inline size_t
+get_overlay_nbytes(const TriggerCandidate& candidate, const TAStore& store)
+{
+  using Overlay = TypeToOverlayType<TriggerCandidate>::overlay_t;
+  size_t n_inputs = candidate.inputs.size();
+  for (const auto& ref : candidate.input_refs)
+    if (store.find(ref))
+      ++n_inputs;
+  return sizeof(Overlay) + n_inputs * sizeof(Overlay::input_t);
+}
+
+inline void
+write_overlay(const TriggerCandidate& candidate, void* buffer, const TAStore& store)
+{
+  using Overlay = TypeToOverlayType<TriggerCandidate>::overlay_t;
+  using Data = TypeToOverlayType<TriggerCandidate>::data_t;
+  Overlay* overlay = reinterpret_cast<Overlay*>(buffer);
+  overlay->data = static_cast<Data>(candidate);
+  uint64_t n_inputs = 0;
+  for (const auto& input : candidate.inputs)
+    overlay->inputs[n_inputs++] = input;
+  for (const auto& ref : candidate.input_refs)
+    if (const auto* activity = store.find(ref))
+      overlay->inputs[n_inputs++] = *activity;
+  overlay->n_inputs = n_inputs;
+}
+
 // Given an overlay object (dunedaq::trgdataformats::TriggerActivity or
 // dunedaq::trgdataformats::TriggerCandidate), create a corresponding non-overlay object
 // (triggeralgs::TriggerActivity or triggeralgs::TriggerCandidate) with the same contents, and return it
@@ -89,6 +146,7 @@ read_overlay(const Overlay& overlay)
   // reference semantics (without the &, we get a _copy_ of ret, which
   // is not what we want)
   *static_cast<Data*>(&ret) = overlay.data;
+  ret.inputs.reserve(overlay.n_inputs);
   for (uint64_t i = 0; i < overlay.n_inputs; ++i) {
     ret.inputs.push_back(overlay.inputs[i]);
   }
@@ -110,6 +168,259 @@ read_overlay_from_buffer(const void* buffer)
   return read_overlay<Object, Overlay>(*reinterpret_cast<const Overlay*>(buffer));
 }
 
+// A read-only range over `size` objects at `data`, which it doesn't own
+template<class T>
+class InputSpan
+{
+public:
+  InputSpan() = default;
+  InputSpan(const T* data, size_t size)
+    : m_data(data)
+    , m_size(size)
+  {}
+
+  const T* begin() const { return m_data; }
+  const T* end() const { return m_data + m_size; }
+  const T* data() const { return m_data; }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  const T& operator[](size_t i) const { return m_data[i]; }
+  const T& front() const { return m_data[0]; }
+  const T& back() const { return m_data[m_size - 1]; }
+
+private:
+  const T* m_data = nullptr;
+  size_t m_size = 0;
+};
+
+// A view of an overlay in a buffer, giving access to its data header and
+// inputs without copying them into a new Trigger(Activity|Candidate). The
+// view points into the buffer, which must outlive it. Eg
+//
+//   ActivityView view(buffer, nbytes);
+//   if (view.is_valid())
+//     for (const auto& tp : view.inputs()) ...
+template<class Object, class Overlay = typename TypeToOverlayType<Object>::overlay_t,
+         class Data = typename TypeToOverlayType<Object>::data_t>
+class OverlayView
+{
+public:
+  using input_t = typename Overlay::input_t;
+
+  // View the overlay at the start of `buffer`, which holds `nbytes`
+  // bytes. If the buffer is too small for the overlay and all of the
+  // inputs it claims to have, the view is invalid and has no inputs.
+  OverlayView(const void* buffer, size_t nbytes)
+    : m_overlay(reinterpret_cast<const Overlay*>(buffer))
+  {
+    m_valid = buffer != nullptr && nbytes >= sizeof(Overlay) &&
+              m_overlay->n_inputs <= (nbytes - sizeof(Overlay)) / sizeof(input_t);
+  }
+
+  // View an overlay whose size is already known to be right
+  explicit OverlayView(const Overlay& overlay)
+    : m_overlay(&overlay)
+    , m_valid(true)
+  {}
+
+  bool is_valid() const { return m_valid; }
+  // The data header. An invalid view may not even have one in its buffer, so check
+  // is_valid() first: this asserts, and outside debug builds gives an empty header.
+  const Data& data() const
+  {
+    assert(m_valid);
+    static const Data s_empty{};
+    return m_valid ? m_overlay->data : s_empty;
+  }
+  InputSpan<input_t> inputs() const
+  {
+    return m_valid ? InputSpan<input_t>(m_overlay->inputs, m_overlay->n_inputs) : InputSpan<input_t>();
+  }
+  // Size of the viewed overlay in bytes, as from get_overlay_nbytes()
+  size_t nbytes() const { return sizeof(Overlay) + inputs().size() * sizeof(input_t); }
+
+  // Copy the overlay into a new Trigger(Activity|Candidate), as read_overlay() does. Like
+  // data(), this asserts on an invalid view, and otherwise gives an empty object.
+  Object materialize() const
+  {
+    Object ret;
+    assert(m_valid);
+    if (!m_valid)
+      return ret;
+    *static_cast<Data*>(&ret) = data();
+    InputSpan<input_t> in = inputs();
+    ret.inputs.assign(in.begin(), in.end());
+    return ret;
+  }
+
+private:
+  const Overlay* m_overlay;
+  bool m_valid = false;
+};
+
+using ActivityView = OverlayView<TriggerActivity>;
+using CandidateView = OverlayView<TriggerCandidate>;
+
+// A batch of overlays is written into one buffer as
+//
+//   uint64_t n_objects
+//   uint64_t offsets[n_objects]  // of each overlay from the start of the buffer
+//   overlay 0, overlay 1, ...
+//
+// with each overlay padded to the overlay's alignment, so a buffer aligned
+// for uint64_t (eg from a std::vector<uint64_t>) is aligned for all of them.
+
+// Size in bytes of an overlay with `n_inputs` inputs, padded to the start of the next
+template<class Overlay>
+constexpr size_t
+get_padded_overlay_nbytes(size_t n_inputs)
+{
+  size_t nbytes = sizeof(Overlay) + n_inputs * sizeof(typename Overlay::input_t);
+  return (nbytes + alignof(Overlay) - 1) / alignof(Overlay) * alignof(Overlay);
+}
+
+// Calculate the size of buffer (in bytes) required to store the
+// `n_objects` objects at `objects` with write_overlay_batch()
+template<class Object, class Overlay = typename TypeToOverlayType<Object>::overlay_t>
+size_t
+get_overlay_batch_nbytes(const Object* objects, size_t n_objects)
+{
+  size_t nbytes = sizeof(uint64_t) * (1 + n_objects);
+  for (size_t i = 0; i < n_objects; ++i) {
+    assert(get_n_input_refs(objects[i]) == 0);
+    nbytes += get_padded_overlay_nbytes<Overlay>(objects[i].inputs.size());
+  }
+  return nbytes;
+}
+
+template<class Object>
+size_t
+get_overlay_batch_nbytes(const std::vector<Object>& objects)
+{
+  return get_overlay_batch_nbytes(objects.data(), objects.size());
+}
+
+// Write the `n_objects` objects at `objects` back to back into `buffer`,
+// with the offset table in front. `buffer` must be aligned for uint64_t
+// and hold get_overlay_batch_nbytes() bytes, which is also returned.
+template<class Object, class Overlay = typename TypeToOverlayType<Object>::overlay_t,
+         class Data = typename TypeToOverlayType<Object>::data_t>
+size_t
+write_overlay_batch(const Object* objects, size_t n_objects, void* buffer)
+{
+  using input_t = typename Overlay::input_t;
+  static_assert(std::is_same<typename decltype(Object::inputs)::value_type, input_t>::value &&
+                  std::is_trivially_copyable<input_t>::value,
+                "The inputs are copied to the overlay with memcpy");
+  static_assert(alignof(Overlay) <= alignof(uint64_t), "The batch is only aligned for uint64_t");
+
+  char* bytes = static_cast<char*>(buffer);
+  uint64_t* header = static_cast<uint64_t*>(buffer);
+  header[0] = n_objects;
+  size_t offset = sizeof(uint64_t) * (1 + n_objects);
+  for (size_t i = 0; i < n_objects; ++i) {
+    const Object& object = objects[i];
+    assert(get_n_input_refs(object) == 0);
+    header[1 + i] = offset;
+    Overlay* overlay = reinterpret_cast<Overlay*>(bytes + offset);
+    overlay->data = static_cast<Data>(object);
+    overlay->n_inputs = object.inputs.size();
+    if (!object.inputs.empty())
+      std::memcpy(overlay->inputs, object.inputs.data(), object.inputs.size() * sizeof(input_t));
+    offset += get_padded_overlay_nbytes<Overlay>(object.inputs.size());
+  }
+  return offset;
+}
+
+// As above, into a new buffer of the right size. Eg
+//
+//   std::vector<uint64_t> batch = write_overlay_batch(candidates);
+//   send(batch.data(), get_overlay_batch_nbytes(candidates));
+template<class Object>
+std::vector<uint64_t>
+write_overlay_batch(const std::vector<Object>& objects)
+{
+  size_t nbytes = get_overlay_batch_nbytes(objects);
+  std::vector<uint64_t> buffer((nbytes + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  write_overlay_batch(objects.data(), objects.size(), buffer.data());
+  return buffer;
+}
+
+// A view of a batch written by write_overlay_batch(), giving an OverlayView
+// of each overlay in it without copying. The constructor checks the offset
+// table and every overlay against the buffer size; if any of them don't fit,
+// the batch is invalid and empty. Eg
+//
+//   OverlayBatchView<TriggerCandidate> batch(buffer, nbytes);
+//   for (const CandidateView& tc : batch) ...
+template<class Object, class Overlay = typename TypeToOverlayType<Object>::overlay_t>
+class OverlayBatchView
+{
+public:
+  using view_t = OverlayView<Object, Overlay>;
+
+  class const_iterator
+  {
+  public:
+    const_iterator(const OverlayBatchView* batch, size_t index)
+      : m_batch(batch)
+      , m_index(index)
+    {}
+    view_t operator*() const { return (*m_batch)[m_index]; }
+    const_iterator& operator++()
+    {
+      ++m_index;
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+    bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+  private:
+    const OverlayBatchView* m_batch;
+    size_t m_index;
+  };
+
+  OverlayBatchView(const void* buffer, size_t nbytes)
+    : m_bytes(static_cast<const char*>(buffer))
+  {
+    if (buffer == nullptr || nbytes < sizeof(uint64_t))
+      return;
+    const uint64_t* header = static_cast<const uint64_t*>(buffer);
+    uint64_t n_objects = header[0];
+    if (n_objects > nbytes / sizeof(uint64_t) - 1)
+      return;
+
+    // Each overlay has to start after the table, inside the buffer, and
+    // hold all of its inputs before the end of the buffer.
+    size_t table_end = sizeof(uint64_t) * (1 + n_objects);
+    for (uint64_t i = 0; i < n_objects; ++i) {
+      uint64_t offset = header[1 + i];
+      if (offset < table_end || offset > nbytes || offset % alignof(Overlay) != 0 ||
+          !view_t(m_bytes + offset, nbytes - offset).is_valid())
+        return;
+    }
+    m_offsets = header + 1;
+    m_size = n_objects;
+  }
+
+  bool is_valid() const { return m_offsets != nullptr; }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  view_t operator[](size_t i) const
+  {
+    return view_t(*reinterpret_cast<const Overlay*>(m_bytes + m_offsets[i]));
+  }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, m_size); }
+
+private:
+  const char* m_bytes;
+  const uint64_t* m_offsets = nullptr;
+  size_t m_size = 0;
+};
+
 } // namespace triggeralgs
 
 #endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_TRIGGEROBJECTOVERLAY_HPP_
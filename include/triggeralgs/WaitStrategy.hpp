@@ -0,0 +1,105 @@
+/**
+ * @file WaitStrategy.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_WAITSTRATEGY_HPP_
+#define TRIGGERALGS_WAITSTRATEGY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace triggeralgs {
+
+/// What a thread does while the queue it reads is empty (or the one it writes full):
+///  - kSpin:  busy-poll. Lowest latency, burns a core per thread.
+///  - kYield: poll, giving the core away between tries.
+///  - kPark:  spin briefly, then sleep until the other side signals (or a short timeout).
+enum class WaitMode
+{
+  kSpin,
+  kYield,
+  kPark
+};
+
+inline bool
+parse_wait_mode(const std::string& name, WaitMode& mode)
+{
+  if (name == "spin")
+    mode = WaitMode::kSpin;
+  else if (name == "yield")
+    mode = WaitMode::kYield;
+  else if (name == "park")
+    mode = WaitMode::kPark;
+  else
+    return false;
+  return true;
+}
+
+/// @brief Wait/notify pair for one side of a queue.
+///
+/// The waiting side calls wait() in its polling loop, and resets the backoff with reset()
+/// once it makes progress. The other side calls notify() after every successful push/pop;
+/// this is a single relaxed load unless someone is actually parked.
+class WaitStrategy
+{
+public:
+  explicit WaitStrategy(WaitMode mode)
+    : m_mode(mode)
+  {}
+
+  void wait()
+  {
+    switch (m_mode) {
+      case WaitMode::kSpin:
+        break;
+      case WaitMode::kYield:
+        std::this_thread::yield();
+        break;
+      case WaitMode::kPark:
+        if (++m_n_tries < s_spins_before_park) {
+          std::this_thread::yield();
+          break;
+        }
+        {
+          // The timeout covers a notify() that lands between the caller's last check and here.
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_parked.store(true, std::memory_order_seq_cst);
+          m_cv.wait_for(lock, s_park_timeout);
+          m_parked.store(false, std::memory_order_relaxed);
+        }
+        break;
+    }
+  }
+
+  void reset() { m_n_tries = 0; }
+
+  void notify()
+  {
+    if (m_mode == WaitMode::kPark && m_parked.load(std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_cv.notify_one();
+    }
+  }
+
+private:
+  static constexpr unsigned s_spins_before_park = 64;
+  static constexpr std::chrono::microseconds s_park_timeout{ 200 };
+
+  WaitMode m_mode;
+  unsigned m_n_tries = 0;
+  std::atomic<bool> m_parked{ false };
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_WAITSTRATEGY_HPP_
@@ -20,11 +20,18 @@ class TriggerActivityMakerDBSCAN : public TriggerActivityMaker
 {
 
 public:
+  TriggerActivityMakerDBSCAN() { m_metrics.set_supported(); }
+  using TriggerActivityMaker::operator();
+  using TriggerActivityMaker::flush;
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
   
   void configure(const nlohmann::json &config);
   
 private:  
+  void make_tas(std::vector<TriggerActivity>& output_ta) const; // One TA per cluster in m_dbscan_clusters
+  void record_latency(timestamp_t now, const std::vector<TriggerActivity>& output_ta); // Of the TAs from make_tas()
   int m_eps{10};
   int m_min_pts{3}; // Minimum number of points to form a cluster
   timestamp_t m_first_timestamp{0};
@@ -20,6 +20,7 @@ class TriggerCandidateMakerDBSCAN : public TriggerCandidateMaker
 {
 
 public:
+  using TriggerCandidateMaker::operator();
   void operator()(const TriggerActivity& input_ta, std::vector<TriggerCandidate>& output_tc);
   void configure(const nlohmann::json &config);
 
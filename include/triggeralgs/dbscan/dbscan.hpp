@@ -76,10 +76,16 @@ public:
     // previously added
     void add_hit(Hit* new_hit, std::vector<Cluster>* completed_clusters=nullptr);
 
+    // Complete every cluster that no hit at or after `until` (in TP
+    // time ticks) could still join
+    void flush(uint64_t until, std::vector<Cluster>* completed_clusters=nullptr);
+
     void trim_hits();
 
     std::vector<Hit*> get_hits() const { return m_hits; }
 
+    size_t get_n_hits() const { return m_hits.size(); }
+
     std::map<int, Cluster> get_clusters() const { return m_clusters; }
 
     uint64_t get_first_prim_time() const { return m_first_prim_time; }
@@ -91,6 +97,10 @@ private:
     // to `cluster`
     void cluster_reachable(Hit* seed_hit, Cluster& cluster);
 
+    // Move clusters whose latest hit is more than eps before
+    // `latest_time` out of the active list
+    void complete_clusters(float latest_time, std::vector<Cluster>* completed_clusters);
+
     float m_eps;
     float m_minPts;
     std::vector<Hit> m_hit_pool;
@@ -0,0 +1,32 @@
+/**
+ * @file Affinity.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/Affinity.hpp"
+
+#include <sched.h>
+
+namespace triggeralgs {
+
+bool
+pin_current_thread(const std::vector<int>& cores)
+{
+  if (cores.empty())
+    return true;
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int core : cores) {
+    if (core < 0 || core >= CPU_SETSIZE)
+      return false;
+    CPU_SET(core, &set);
+  }
+  // pid 0 is the calling thread.
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+} // namespace triggeralgs
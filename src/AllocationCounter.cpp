@@ -0,0 +1,198 @@
+/**
+ * @file AllocationCounter.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace triggeralgs {
+
+namespace {
+// Plain integers, so they need no initialization guard and operator new can touch them
+// from the first allocation of a thread on.
+thread_local AllocationCounts t_allocations;
+} // namespace
+
+bool
+allocation_counting_enabled()
+{
+#ifdef TRIGGERALGS_COUNT_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+AllocationCounts
+get_thread_allocations()
+{
+  return t_allocations;
+}
+
+#ifdef TRIGGERALGS_COUNT_ALLOCATIONS
+namespace {
+void*
+counted_malloc(std::size_t size)
+{
+  t_allocations.n_allocations++;
+  t_allocations.n_bytes += size;
+  return std::malloc(size ? size : 1);
+}
+
+void*
+counted_aligned_alloc(std::size_t size, std::align_val_t alignment)
+{
+  t_allocations.n_allocations++;
+  t_allocations.n_bytes += size;
+  // aligned_alloc wants a non-zero size that is a multiple of the alignment.
+  std::size_t align = static_cast<std::size_t>(alignment);
+  std::size_t n_bytes = size ? (size + align - 1) / align * align : align;
+  return std::aligned_alloc(align, n_bytes);
+}
+
+void
+counted_free(void* ptr)
+{
+  if (!ptr)
+    return;
+  t_allocations.n_deallocations++;
+  std::free(ptr);
+}
+} // namespace
+#endif
+
+} // namespace triggeralgs
+
+#ifdef TRIGGERALGS_COUNT_ALLOCATIONS
+// Replacements for the global allocation functions. Every form funnels into the three above.
+
+void*
+operator new(std::size_t size)
+{
+  if (void* ptr = triggeralgs::counted_malloc(size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void*
+operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return triggeralgs::counted_malloc(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return triggeralgs::counted_malloc(size);
+}
+
+void*
+operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (void* ptr = triggeralgs::counted_aligned_alloc(size, alignment))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void*
+operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+void*
+operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return triggeralgs::counted_aligned_alloc(size, alignment);
+}
+
+void*
+operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return triggeralgs::counted_aligned_alloc(size, alignment);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete(void* ptr, std::align_val_t) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+
+void
+operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  triggeralgs::counted_free(ptr);
+}
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file FlushScheduler.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/FlushScheduler.hpp"
+
+#include <limits>
+
+namespace triggeralgs {
+
+FlushScheduler::FlushScheduler(TriggerActivityMaker& ta_maker, TriggerCandidateMaker& tc_maker)
+  : m_ta_maker(ta_maker)
+  , m_tc_maker(tc_maker)
+{}
+
+void
+FlushScheduler::configure(const nlohmann::json& config)
+{
+  if (config.is_object()) {
+    if (config.contains("flush_interval"))
+      m_flush_interval = config["flush_interval"];
+    if (config.contains("candidate_delay"))
+      m_candidate_delay = config["candidate_delay"];
+  }
+  m_next_flush = 0;
+}
+
+void
+FlushScheduler::operator()(const TriggerPrimitive& input_tp,
+                           std::vector<TriggerActivity>& output_ta,
+                           std::vector<TriggerCandidate>& output_tc)
+{
+  size_t first_ta = output_ta.size();
+  m_ta_maker(input_tp, output_ta);
+  make_candidates(first_ta, output_ta, output_tc);
+
+  // With time ordered TPs, nothing earlier than this one can still arrive.
+  heartbeat(input_tp.time_start, output_ta, output_tc);
+}
+
+void
+FlushScheduler::heartbeat(timestamp_t time,
+                          std::vector<TriggerActivity>& output_ta,
+                          std::vector<TriggerCandidate>& output_tc)
+{
+  if (time < m_next_flush)
+    return;
+  // Saturate, so the end of stream (time at its largest) doesn't wrap round to an early flush.
+  m_next_flush = time > std::numeric_limits<timestamp_t>::max() - m_flush_interval ? std::numeric_limits<timestamp_t>::max()
+                                                                                   : time + m_flush_interval;
+
+  size_t first_ta = output_ta.size();
+  m_ta_maker.flush(time, output_ta);
+  make_candidates(first_ta, output_ta, output_tc);
+
+  if (time > m_candidate_delay)
+    m_tc_maker.flush(time - m_candidate_delay, output_tc);
+}
+
+void
+FlushScheduler::make_candidates(size_t first_ta,
+                                std::vector<TriggerActivity>& output_ta,
+                                std::vector<TriggerCandidate>& output_tc)
+{
+  for (size_t i = first_ta; i < output_ta.size(); ++i)
+    m_tc_maker(output_ta[i], output_tc);
+}
+
+} // namespace triggeralgs
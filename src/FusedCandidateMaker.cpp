@@ -0,0 +1,111 @@
+/**
+ * @file FusedCandidateMaker.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/FusedCandidateMaker.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "FusedCandidateMakerPlugin"
+
+#include <utility>
+
+namespace triggeralgs {
+
+using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
+
+void
+FusedCandidateMaker::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerCandidate>& output_tc)
+{
+  if (!m_ta_maker || !m_tc_maker)
+    return;
+
+  (*m_ta_maker)(input_tp, m_activities);
+  make_candidates(output_tc);
+}
+
+void
+FusedCandidateMaker::flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc)
+{
+  if (!m_ta_maker || !m_tc_maker)
+    return;
+
+  m_ta_maker->flush(until, m_activities);
+  make_candidates(output_tc);
+
+  // A TA still open in the TA maker can start up to candidate_delay ticks before until.
+  if (until > m_candidate_delay)
+    m_tc_maker->flush(until - m_candidate_delay, output_tc);
+}
+
+void
+FusedCandidateMaker::make_candidates(std::vector<TriggerCandidate>& output_tc)
+{
+  for (auto& ta : m_activities)
+    (*m_tc_maker)(std::move(ta), output_tc);
+  m_n_activities += m_activities.size();
+  // Keeps the capacity for the next call.
+  m_activities.clear();
+}
+
+void
+FusedCandidateMaker::configure(const nlohmann::json& config)
+{
+  if (config.is_object()) {
+    if (config.contains("activity_maker"))
+      m_ta_maker_name = config["activity_maker"];
+    if (config.contains("candidate_maker"))
+      m_tc_maker_name = config["candidate_maker"];
+    if (config.contains("candidate_delay"))
+      m_candidate_delay = config["candidate_delay"];
+  }
+
+  m_activities.clear();
+  m_n_activities = 0;
+  m_ta_maker = TriggerActivityFactory::get_instance()->build_maker(m_ta_maker_name);
+  m_tc_maker = TriggerCandidateFactory::get_instance()->build_maker(m_tc_maker_name);
+  if (!m_ta_maker || !m_tc_maker) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[FCM] Factory couldn't find " << m_ta_maker_name << " or "
+                                                << m_tc_maker_name << ", no TCs will be made.";
+    m_ta_maker.reset();
+    m_tc_maker.reset();
+    return;
+  }
+  if (config.is_object() && config.contains("activity_config"))
+    m_ta_maker->configure(config["activity_config"]);
+  if (config.is_object() && config.contains("candidate_config"))
+    m_tc_maker->configure(config["candidate_config"]);
+  m_ta_maker->enable_metrics(m_metrics_enabled);
+  m_tc_maker->enable_metrics(m_metrics_enabled);
+
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[FCM] Running " << m_ta_maker_name << " into " << m_tc_maker_name << ".";
+}
+
+void
+FusedCandidateMaker::enable_metrics(bool enable)
+{
+  m_metrics_enabled = enable;
+  if (m_ta_maker)
+    m_ta_maker->enable_metrics(enable);
+  if (m_tc_maker)
+    m_tc_maker->enable_metrics(enable);
+}
+
+nlohmann::json
+FusedCandidateMaker::get_metrics() const
+{
+  nlohmann::json metrics = nlohmann::json::object();
+  if (m_ta_maker)
+    metrics["activity"] = m_ta_maker->get_metrics();
+  if (m_tc_maker)
+    metrics["candidate"] = m_tc_maker->get_metrics();
+  return metrics;
+}
+
+REGISTER_CANDIDATE_PIPELINE(TRACE_NAME, FusedCandidateMaker)
+
+} // namespace triggeralgs
@@ -0,0 +1,61 @@
+/**
+ * @file LatencyHistogram.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace triggeralgs {
+
+uint64_t
+LatencyHistogram::bucket_max(size_t index)
+{
+  if (index < s_sub_buckets)
+    return index;
+  int shift = static_cast<int>(index >> s_sub_bits) - 1;
+  uint64_t lowest = (s_sub_buckets + (index & (s_sub_buckets - 1))) << shift;
+  return lowest + ((uint64_t(1) << shift) - 1);
+}
+
+uint64_t
+LatencyHistogram::get_quantile(double quantile) const
+{
+  // The counts may move on while they are read, so go by what is actually in the buckets.
+  uint64_t total = 0;
+  for (const auto& count : m_counts)
+    total += count.load(std::memory_order_relaxed);
+  if (total == 0)
+    return 0;
+
+  uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * total)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < s_n_buckets; ++i) {
+    seen += m_counts[i].load(std::memory_order_relaxed);
+    if (seen >= rank)
+      return std::min(bucket_max(i), m_max.load(std::memory_order_relaxed));
+  }
+  return m_max.load(std::memory_order_relaxed);
+}
+
+nlohmann::json
+LatencyHistogram::get_json() const
+{
+  uint64_t count = get_count();
+  nlohmann::json histogram;
+  histogram["count"] = count;
+  histogram["mean"] = count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count : 0.;
+  histogram["p50"] = get_quantile(0.5);
+  histogram["p90"] = get_quantile(0.9);
+  histogram["p99"] = get_quantile(0.99);
+  histogram["p99.9"] = get_quantile(0.999);
+  histogram["max"] = m_max.load(std::memory_order_relaxed);
+  return histogram;
+}
+
+} // namespace triggeralgs
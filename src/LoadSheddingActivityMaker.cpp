@@ -0,0 +1,250 @@
+/**
+ * @file LoadSheddingActivityMaker.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/LoadSheddingActivityMaker.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "LoadSheddingActivityMakerPlugin"
+
+#include <algorithm>
+#include <chrono>
+
+namespace triggeralgs {
+
+using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
+
+namespace {
+int64_t
+now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+} // namespace
+
+void
+LoadSheddingActivityMaker::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+{
+  if (!m_maker)
+    return;
+  MakerMetrics::Scope scope(m_metrics, output_ta);
+
+  if (!m_started) {
+    m_started = true;
+    m_data_start = input_tp.time_start;
+    m_wall_start_ns = now_ns();
+  }
+  if (++m_n_since_check >= m_check_interval) {
+    m_n_since_check = 0;
+    check_load(input_tp.time_start, output_ta);
+  }
+
+  uint64_t prescale = block_prescale();
+  if (prescale > 1) {
+    timestamp_t block = input_tp.time_start / m_block_length;
+    if (block % prescale != 0) {
+      // Nothing before this block will be passed on, so close whatever the maker has open.
+      if (m_maker_fed) {
+        active_maker().flush(block * m_block_length, output_ta);
+        m_maker_fed = false;
+      }
+      m_n_shed++;
+      m_metrics.count_drops();
+      return;
+    }
+  }
+
+  active_maker()(input_tp, output_ta);
+  m_maker_fed = true;
+}
+
+void
+LoadSheddingActivityMaker::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  if (!m_maker)
+    return;
+  active_maker().flush(until, output_ta);
+}
+
+void
+LoadSheddingActivityMaker::check_load(timestamp_t data_time, std::vector<TriggerActivity>& output_ta)
+{
+  int64_t wall_ns = now_ns();
+  bool over = false;
+  bool calm = true;
+  bool falling = true; // Whether every load measure went down since the last check
+
+  if (m_max_backlog > 0) {
+    over |= m_backlog > m_max_backlog;
+    calm &= m_backlog <= m_max_backlog / 2;
+    falling &= m_backlog < m_last_backlog;
+    m_last_backlog = m_backlog;
+  }
+
+  // Wall time ahead of data time, in ticks. Its smallest value is taken as keeping up, so
+  // the lag is how far behind that the data has fallen since.
+  int64_t lag = 0;
+  if (m_max_lag > 0) {
+    int64_t offset = static_cast<int64_t>((wall_ns - m_wall_start_ns) * 1e-9 * m_clock_frequency_hz) -
+                     static_cast<int64_t>(data_time - m_data_start);
+    m_min_offset = std::min(m_min_offset, offset);
+    lag = offset - m_min_offset;
+    over |= lag > m_max_lag;
+    calm &= lag <= m_max_lag / 2;
+    falling &= lag < m_last_lag;
+    m_last_lag = lag;
+  }
+
+  // Shedding takes a while to catch up, so only go further while the load is still growing.
+  if (over) {
+    m_n_calm_checks = 0;
+    if (m_level < m_max_level && !falling)
+      set_level(m_level + 1, data_time, wall_ns, lag, output_ta);
+  } else if (calm && m_level > 0) {
+    if (++m_n_calm_checks >= m_recover_checks) {
+      m_n_calm_checks = 0;
+      set_level(m_level - 1, data_time, wall_ns, lag, output_ta);
+    }
+  } else {
+    m_n_calm_checks = 0;
+  }
+}
+
+void
+LoadSheddingActivityMaker::set_level(uint16_t level,
+                                     timestamp_t data_time,
+                                     int64_t wall_ns,
+                                     int64_t lag,
+                                     std::vector<TriggerActivity>& output_ta)
+{
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:LS] Shedding level " << m_level << " -> " << level << " at " << data_time
+                                         << " with backlog " << m_backlog << " and lag " << lag << " ticks, "
+                                         << m_n_shed << " TPs shed so far.";
+  if (m_max_decisions > 0) {
+    if (m_decisions.size() >= m_max_decisions) {
+      m_decisions.pop_front();
+      m_n_decisions_dropped++;
+    }
+    m_decisions.push_back({ data_time, wall_ns, m_level, level, m_backlog, lag });
+  }
+
+  // Switching between the maker and the fallback: the one being left sees no more TPs.
+  TriggerActivityMaker* previous = &active_maker();
+  m_level = level;
+  if (&active_maker() != previous) {
+    previous->flush(data_time, output_ta);
+    m_maker_fed = false;
+  }
+}
+
+TriggerActivityMaker&
+LoadSheddingActivityMaker::active_maker() const
+{
+  return (m_fallback && m_level > 0) ? *m_fallback : *m_maker;
+}
+
+uint64_t
+LoadSheddingActivityMaker::block_prescale() const
+{
+  uint16_t prescale_level = (m_fallback && m_level > 0) ? m_level - 1 : m_level;
+  return uint64_t(1) << prescale_level;
+}
+
+void
+LoadSheddingActivityMaker::configure(const nlohmann::json& config)
+{
+  if (config.is_object()) {
+    if (config.contains("maker"))
+      m_maker_name = config["maker"];
+    if (config.contains("fallback_maker"))
+      m_fallback_name = config["fallback_maker"];
+    if (config.contains("max_backlog"))
+      m_max_backlog = config["max_backlog"];
+    if (config.contains("max_lag"))
+      m_max_lag = config["max_lag"];
+    if (config.contains("clock_frequency_hz"))
+      m_clock_frequency_hz = config["clock_frequency_hz"];
+    if (config.contains("check_interval"))
+      m_check_interval = config["check_interval"];
+    if (config.contains("recover_checks"))
+      m_recover_checks = config["recover_checks"];
+    if (config.contains("max_level"))
+      m_max_level = config["max_level"];
+    if (config.contains("block_length"))
+      m_block_length = config["block_length"];
+    if (config.contains("max_decisions"))
+      m_max_decisions = config["max_decisions"];
+  }
+  // Keep 2^level within a 64 bit prescale.
+  m_max_level = std::min<uint16_t>(m_max_level, 32);
+
+  m_level = 0;
+  m_backlog = 0;
+  m_n_since_check = 0;
+  m_n_calm_checks = 0;
+  m_n_shed = 0;
+  m_maker_fed = false;
+  m_started = false;
+  m_min_offset = 0;
+  m_last_backlog = 0;
+  m_last_lag = 0;
+  m_decisions.clear();
+  m_n_decisions_dropped = 0;
+
+  m_fallback.reset();
+  m_maker = TriggerActivityFactory::get_instance()->build_maker(m_maker_name);
+  if (!m_maker) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:LS] Factory couldn't find " << m_maker_name << ", no TAs will be made.";
+    return;
+  }
+  if (config.is_object() && config.contains("maker_config"))
+    m_maker->configure(config["maker_config"]);
+  m_maker->enable_metrics(m_metrics.is_enabled());
+
+  if (!m_fallback_name.empty()) {
+    m_fallback = TriggerActivityFactory::get_instance()->build_maker(m_fallback_name);
+    if (!m_fallback) {
+      TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:LS] Factory couldn't find fallback " << m_fallback_name
+                                                  << ", shedding by prescale only.";
+    } else {
+      if (config.contains("fallback_config"))
+        m_fallback->configure(config["fallback_config"]);
+      m_fallback->enable_metrics(m_metrics.is_enabled());
+    }
+  }
+
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:LS] Running " << m_maker_name << " with max_backlog " << m_max_backlog
+                                         << " and max_lag " << m_max_lag << " ticks.";
+}
+
+void
+LoadSheddingActivityMaker::enable_metrics(bool enable)
+{
+  m_metrics.set_enabled(enable);
+  if (m_maker)
+    m_maker->enable_metrics(enable);
+  if (m_fallback)
+    m_fallback->enable_metrics(enable);
+}
+
+nlohmann::json
+LoadSheddingActivityMaker::get_metrics() const
+{
+  nlohmann::json metrics = m_metrics.get_json();
+  if (m_maker)
+    metrics["maker"] = m_maker->get_metrics();
+  if (m_fallback)
+    metrics["fallback"] = m_fallback->get_metrics();
+  return metrics;
+}
+
+REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, LoadSheddingActivityMaker)
+
+} // namespace triggeralgs
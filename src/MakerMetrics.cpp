@@ -0,0 +1,65 @@
+/**
+ * @file MakerMetrics.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/MakerMetrics.hpp"
+
+namespace triggeralgs {
+
+nlohmann::json
+MakerMetrics::get_json() const
+{
+  nlohmann::json metrics;
+  metrics["enabled"] = m_enabled;
+  metrics["supported"] = m_supported;
+  if (!m_supported)
+    return metrics;
+  metrics["inputs"] = m_n_inputs.load(std::memory_order_relaxed);
+  metrics["outputs"] = m_n_outputs.load(std::memory_order_relaxed);
+  metrics["drops"] = m_n_drops.load(std::memory_order_relaxed);
+  metrics["busy_ns"] = m_busy_ns.load(std::memory_order_relaxed);
+  metrics["occupancy"] = m_occupancy.load(std::memory_order_relaxed);
+  metrics["occupancy_peak"] = m_occupancy_peak.load(std::memory_order_relaxed);
+
+  nlohmann::json triggers = nlohmann::json::object();
+  for (size_t i = 0; i < s_max_conditions; ++i) {
+    uint64_t n = m_n_triggers[i].load(std::memory_order_relaxed);
+    if (i < m_condition_names.size())
+      triggers[m_condition_names[i]] = n;
+    else if (n > 0)
+      triggers[std::to_string(i)] = n;
+  }
+  metrics["triggers"] = triggers;
+  if (m_latencies && m_latencies->data.get_count() > 0) {
+    metrics["latency_ticks"] = m_latencies->data.get_json();
+    metrics["latency_ns"] = m_latencies->wall.get_json();
+  }
+  return metrics;
+}
+
+void
+MakerMetrics::record_wall_latency(timestamp_t earliest)
+{
+  if (m_arrival_head == 0)
+    return;
+
+  // The kept arrivals are in time order around the ring: find the last one at or before the
+  // earliest input. If it has been overwritten, the oldest kept gives a lower bound.
+  uint64_t first = m_arrival_head > s_n_arrivals ? m_arrival_head - s_n_arrivals : 0;
+  uint64_t lo = first, hi = m_arrival_head;
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    if (m_latencies->arrivals[mid % s_n_arrivals].time <= earliest)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  const Arrival& arrival = m_latencies->arrivals[(lo > first ? lo - 1 : first) % s_n_arrivals];
+  m_latencies->wall.record(std::max<int64_t>(now_ns() - arrival.wall_ns, 0));
+}
+
+} // namespace triggeralgs
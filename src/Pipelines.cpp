@@ -0,0 +1,36 @@
+/**
+ * @file Pipelines.cpp
+ *
+ * The Pipeline instantiations that can be built by name from the CandidatePipelineFactory.
+ * Add a line here to make another TA maker / TC maker pair available.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/CandidatePipelineFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Pipeline.hpp"
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/ADCSimpleWindow/TriggerActivityMakerADCSimpleWindow.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/ADCSimpleWindow/TriggerCandidateMakerADCSimpleWindow.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/ChannelAdjacency/TriggerActivityMakerChannelAdjacency.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/ChannelAdjacency/TriggerCandidateMakerChannelAdjacency.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/HorizontalMuon/TriggerActivityMakerHorizontalMuon.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/HorizontalMuon/TriggerCandidateMakerHorizontalMuon.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Prescale/TriggerActivityMakerPrescale.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Prescale/TriggerCandidateMakerPrescale.hpp"
+
+namespace triggeralgs {
+
+using ADCSimpleWindowPipeline = Pipeline<TriggerActivityMakerADCSimpleWindow, TriggerCandidateMakerADCSimpleWindow>;
+using ChannelAdjacencyPipeline = Pipeline<TriggerActivityMakerChannelAdjacency, TriggerCandidateMakerChannelAdjacency>;
+using HorizontalMuonPipeline = Pipeline<TriggerActivityMakerHorizontalMuon, TriggerCandidateMakerHorizontalMuon>;
+using PrescalePipeline = Pipeline<TriggerActivityMakerPrescale, TriggerCandidateMakerPrescale>;
+
+REGISTER_CANDIDATE_PIPELINE("ADCSimpleWindowPipeline", ADCSimpleWindowPipeline)
+REGISTER_CANDIDATE_PIPELINE("ChannelAdjacencyPipeline", ChannelAdjacencyPipeline)
+REGISTER_CANDIDATE_PIPELINE("HorizontalMuonPipeline", HorizontalMuonPipeline)
+REGISTER_CANDIDATE_PIPELINE("PrescalePipeline", PrescalePipeline)
+
+} // namespace triggeralgs
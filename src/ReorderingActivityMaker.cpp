@@ -0,0 +1,99 @@
+/**
+ * @file ReorderingActivityMaker.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/ReorderingActivityMaker.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "ReorderingActivityMakerPlugin"
+
+#include <algorithm>
+
+namespace triggeralgs {
+
+using Logging::TLVL_DEBUG_LOW;
+using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
+
+void
+ReorderingActivityMaker::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+{
+  if (!m_maker)
+    return;
+
+  MakerMetrics::Scope scope(m_metrics, output_ta);
+  m_reorder->add(input_tp, [&](const TriggerPrimitive& tp) { (*m_maker)(tp, output_ta); });
+  m_metrics.set_occupancy(m_reorder->size());
+
+  if (m_reorder->get_n_late() != m_n_late_reported) {
+    m_metrics.count_drops(m_reorder->get_n_late() - m_n_late_reported);
+    m_n_late_reported = m_reorder->get_n_late();
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:RO] Dropped late TP at " << input_tp.time_start << ", "
+                                           << m_n_late_reported << " late so far.";
+  }
+}
+
+void
+ReorderingActivityMaker::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  if (!m_maker)
+    return;
+
+  // Only whole buckets are released, so the maker may have seen TPs up to a little before until.
+  size_t n_outputs = output_ta.size();
+  m_reorder->release_until(until, [&](const TriggerPrimitive& tp) { (*m_maker)(tp, output_ta); });
+  m_maker->flush(std::min(until, m_reorder->released_until()), output_ta);
+  m_metrics.count_outputs(output_ta.size() - n_outputs);
+  m_metrics.set_occupancy(m_reorder->size());
+}
+
+void
+ReorderingActivityMaker::configure(const nlohmann::json& config)
+{
+  if (config.is_object()) {
+    if (config.contains("maker"))
+      m_maker_name = config["maker"];
+    if (config.contains("horizon"))
+      m_horizon = config["horizon"];
+    if (config.contains("bucket_width"))
+      m_bucket_width = config["bucket_width"];
+  }
+
+  m_reorder = std::make_unique<TPReorderBuffer>(m_horizon, m_bucket_width);
+  m_n_late_reported = 0;
+  m_maker = TriggerActivityFactory::get_instance()->build_maker(m_maker_name);
+  if (!m_maker) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:RO] Factory couldn't find " << m_maker_name << ", no TAs will be made.";
+    return;
+  }
+  if (config.is_object() && config.contains("maker_config"))
+    m_maker->configure(config["maker_config"]);
+  m_maker->enable_metrics(m_metrics.is_enabled());
+
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:RO] Reordering TPs for " << m_maker_name << " over " << m_horizon << " ticks.";
+}
+
+void
+ReorderingActivityMaker::enable_metrics(bool enable)
+{
+  m_metrics.set_enabled(enable);
+  if (m_maker)
+    m_maker->enable_metrics(enable);
+}
+
+nlohmann::json
+ReorderingActivityMaker::get_metrics() const
+{
+  nlohmann::json metrics = m_metrics.get_json();
+  if (m_maker)
+    metrics["maker"] = m_maker->get_metrics();
+  return metrics;
+}
+
+REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, ReorderingActivityMaker)
+
+} // namespace triggeralgs
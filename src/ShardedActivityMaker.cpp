@@ -0,0 +1,284 @@
+/**
+ * @file ShardedActivityMaker.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/ShardedActivityMaker.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Affinity.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "ShardedActivityMakerPlugin"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace triggeralgs {
+
+using Logging::TLVL_DEBUG_MEDIUM;
+using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
+
+ShardedActivityMaker::~ShardedActivityMaker()
+{
+  stop_workers();
+}
+
+void
+ShardedActivityMaker::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+{
+  if (m_shards.empty())
+    return;
+
+  MakerMetrics::Scope scope(m_metrics, output_ta);
+  size_t shard_index = route(input_tp);
+  if (shard_index >= m_shards.size()) {
+    m_metrics.count_drops();
+    if (m_n_unrouted++ == 0) {
+      TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:SH] TP on channel " << input_tp.channel << " matches no channel range, dropping it.";
+    }
+    return;
+  }
+
+  // Keep draining the outputs while the input ring is full, otherwise a worker blocked on
+  // its full output ring could never free up space.
+  Shard& shard = *m_shards[shard_index];
+  while (!shard.input.try_push(input_tp)) {
+    drain_outputs();
+    std::this_thread::yield();
+  }
+  shard.input_wait.notify();
+  shard.n_dispatched++;
+  m_last_dispatched = std::max(m_last_dispatched, input_tp.time_start);
+
+  collect(output_ta, false);
+}
+
+void
+ShardedActivityMaker::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // Wait for every worker to go idle. After that they only poll their empty input rings,
+  // so the makers can be flushed from this thread.
+  for (auto& shard : m_shards) {
+    while (shard->n_processed.load(std::memory_order_acquire) != shard->n_dispatched) {
+      drain_outputs();
+      std::this_thread::yield();
+    }
+  }
+  drain_outputs();
+
+  size_t n_outputs = output_ta.size();
+  std::vector<TriggerActivity> flushed;
+  for (auto& shard : m_shards) {
+    shard->maker->flush(until, flushed);
+    for (auto& ta : flushed) {
+      shard->pending.push_back({ until, std::move(ta) });
+    }
+    flushed.clear();
+  }
+
+  collect(output_ta, true);
+  m_metrics.count_outputs(output_ta.size() - n_outputs);
+}
+
+void
+ShardedActivityMaker::configure(const nlohmann::json& config)
+{
+  stop_workers();
+
+  if (config.is_object()) {
+    if (config.contains("maker"))
+      m_maker_name = config["maker"];
+    if (config.contains("n_shards"))
+      m_n_shards = config["n_shards"];
+    if (config.contains("ring_capacity"))
+      m_ring_capacity = config["ring_capacity"];
+    if (config.contains("channel_ranges")) {
+      m_channel_ranges = config["channel_ranges"].get<std::vector<std::pair<channel_t, channel_t>>>();
+      m_n_shards = m_channel_ranges.size();
+    }
+    if (config.contains("affinity"))
+      m_affinity = config["affinity"].get<std::vector<std::vector<int>>>();
+  }
+  m_n_shards = std::max<size_t>(m_n_shards, 1);
+
+  nlohmann::json maker_config;
+  if (config.is_object() && config.contains("maker_config"))
+    maker_config = config["maker_config"];
+
+  // The workers build the shards, then this thread waits until they all have.
+  m_shards.clear();
+  m_shards.resize(m_n_shards);
+  m_n_started = 0;
+  m_build_failed = false;
+  m_running = true;
+  for (size_t i = 0; i < m_n_shards; ++i) {
+    m_workers.emplace_back(&ShardedActivityMaker::run_worker, this, i, maker_config);
+  }
+  while (m_n_started.load(std::memory_order_acquire) != m_n_shards) {
+    std::this_thread::yield();
+  }
+  if (m_build_failed) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:SH] Factory couldn't find " << m_maker_name << ", no TAs will be made.";
+    stop_workers();
+    m_shards.clear();
+    return;
+  }
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:SH] Running " << m_shards.size() << " shards of " << m_maker_name << ".";
+}
+
+void
+ShardedActivityMaker::run_worker(size_t index, nlohmann::json maker_config)
+{
+  if (index < m_affinity.size() && !pin_current_thread(m_affinity[index])) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:SH] Couldn't set the CPU affinity of shard " << index
+                                                << ", leaving it unpinned.";
+  }
+
+  // Built after pinning, so the rings and the maker's buffers are first touched here.
+  auto new_shard = std::make_unique<Shard>(m_ring_capacity);
+  new_shard->maker = TriggerActivityFactory::get_instance()->build_maker(m_maker_name);
+  if (new_shard->maker && !maker_config.is_null())
+    new_shard->maker->configure(maker_config);
+  if (new_shard->maker)
+    new_shard->maker->enable_metrics(m_metrics.is_enabled());
+  Shard& shard = *new_shard;
+  bool built = shard.maker != nullptr;
+  if (!built)
+    m_build_failed = true;
+  m_shards[index] = std::move(new_shard);
+  m_n_started.fetch_add(1, std::memory_order_release);
+  if (!built)
+    return;
+
+  TriggerPrimitive tp;
+  std::vector<TriggerActivity> made;
+  while (m_running.load(std::memory_order_relaxed)) {
+    if (!shard.input.try_pop(tp)) {
+      shard.input_wait.wait();
+      continue;
+    }
+    shard.input_wait.reset();
+
+    (*shard.maker)(tp, made);
+    for (auto& ta : made) {
+      TaggedActivity tagged{ tp.time_start, std::move(ta) };
+      while (!shard.output.try_push(std::move(tagged))) {
+        if (!m_running.load(std::memory_order_relaxed))
+          return;
+        shard.output_wait.wait();
+      }
+      shard.output_wait.reset();
+    }
+    made.clear();
+
+    // Publish progress only after this TP's TAs are in the output ring.
+    shard.watermark.store(tp.time_start, std::memory_order_release);
+    shard.n_processed.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void
+ShardedActivityMaker::enable_metrics(bool enable)
+{
+  // The workers only read their maker's flag after the first TP is pushed to them.
+  m_metrics.set_enabled(enable);
+  for (auto& shard : m_shards) {
+    if (shard && shard->maker)
+      shard->maker->enable_metrics(enable);
+  }
+}
+
+nlohmann::json
+ShardedActivityMaker::get_metrics() const
+{
+  nlohmann::json metrics = m_metrics.get_json();
+  nlohmann::json shards = nlohmann::json::array();
+  for (const auto& shard : m_shards) {
+    if (shard && shard->maker)
+      shards.push_back(shard->maker->get_metrics());
+  }
+  metrics["shards"] = shards;
+  return metrics;
+}
+
+void
+ShardedActivityMaker::stop_workers()
+{
+  m_running = false;
+  for (auto& shard : m_shards) {
+    if (shard) {
+      shard->input_wait.notify();
+      shard->output_wait.notify();
+    }
+  }
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+  m_workers.clear();
+}
+
+size_t
+ShardedActivityMaker::route(const TriggerPrimitive& input_tp) const
+{
+  if (m_channel_ranges.empty())
+    return input_tp.detid % m_shards.size();
+
+  for (size_t i = 0; i < m_channel_ranges.size(); ++i) {
+    if (input_tp.channel >= m_channel_ranges[i].first && input_tp.channel <= m_channel_ranges[i].second)
+      return i;
+  }
+  return m_shards.size();
+}
+
+void
+ShardedActivityMaker::drain_outputs()
+{
+  TaggedActivity tagged;
+  for (auto& shard : m_shards) {
+    bool popped = false;
+    while (shard->output.try_pop(tagged)) {
+      shard->pending.push_back(std::move(tagged));
+      popped = true;
+    }
+    if (popped)
+      shard->output_wait.notify();
+  }
+}
+
+void
+ShardedActivityMaker::collect(std::vector<TriggerActivity>& output_ta, bool drain_all)
+{
+  // A shard can still emit TAs tagged at or after its watermark. A shard that has processed
+  // everything sent to it can only emit TAs for TPs it hasn't been given yet, which are no
+  // earlier than the last TP dispatched.
+  timestamp_t release_until = std::numeric_limits<timestamp_t>::max();
+  if (!drain_all) {
+    for (auto& shard : m_shards) {
+      uint64_t n_processed = shard->n_processed.load(std::memory_order_acquire);
+      timestamp_t watermark = shard->watermark.load(std::memory_order_acquire);
+      release_until = std::min(release_until, n_processed == shard->n_dispatched ? m_last_dispatched : watermark);
+    }
+  }
+  drain_outputs();
+
+  // Merge the pending TAs of all shards on their tags.
+  while (true) {
+    Shard* next = nullptr;
+    for (auto& shard : m_shards) {
+      if (!shard->pending.empty() && (!next || shard->pending.front().tag < next->pending.front().tag))
+        next = shard.get();
+    }
+    if (!next || next->pending.front().tag > release_until)
+      break;
+    output_ta.push_back(std::move(next->pending.front().ta));
+    next->pending.pop_front();
+  }
+}
+
+REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, ShardedActivityMaker)
+
+} // namespace triggeralgs
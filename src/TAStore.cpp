@@ -0,0 +1,73 @@
+/**
+ * @file TAStore.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TAStore.hpp"
+
+#include <algorithm>
+
+namespace triggeralgs {
+
+TAStore::TAStore(size_t capacity)
+  : m_capacity(std::max<size_t>(capacity, 1))
+{}
+
+void
+TAStore::set_capacity(size_t capacity)
+{
+  m_capacity = std::max<size_t>(capacity, 1);
+  m_ring.clear();
+  m_next_sequence = 0;
+  m_first_sequence = 0;
+}
+
+ActivityRef
+TAStore::add(const TriggerActivity::TriggerActivityData& activity)
+{
+  // The ring grows to its capacity and then wraps, unless the TA it would overwrite is still
+  // within the retention time. Then the ring doubles, with each TA moved to its new slot, and
+  // the slots for sequence numbers from before the oldest TA left empty.
+  if (m_ring.size() == m_capacity && m_retention > 0 &&
+      m_ring[m_next_sequence % m_capacity].time_start + m_retention > activity.time_start) {
+    std::vector<TriggerActivity::TriggerActivityData> ring(2 * m_capacity);
+    m_first_sequence = m_next_sequence - m_capacity;
+    for (uint64_t sequence = m_first_sequence; sequence < m_next_sequence; ++sequence)
+      ring[sequence % ring.size()] = m_ring[sequence % m_capacity];
+    m_ring = std::move(ring);
+    m_capacity = m_ring.size();
+  }
+  if (m_ring.size() < m_capacity)
+    m_ring.push_back(activity);
+  else
+    m_ring[m_next_sequence % m_capacity] = activity;
+  return { m_next_sequence++, activity.time_start, activity.time_end };
+}
+
+const TriggerActivity::TriggerActivityData*
+TAStore::find(const ActivityRef& ref) const
+{
+  if (ref.sequence >= m_next_sequence || ref.sequence < m_first_sequence || m_next_sequence - ref.sequence > m_capacity)
+    return nullptr;
+  return &m_ring[ref.sequence % m_capacity];
+}
+
+bool
+TAStore::resolve(TriggerCandidate& tc) const
+{
+  bool complete = true;
+  tc.inputs.reserve(tc.inputs.size() + tc.input_refs.size());
+  for (const auto& ref : tc.input_refs) {
+    if (const auto* activity = find(ref))
+      tc.inputs.push_back(*activity);
+    else
+      complete = false;
+  }
+  tc.input_refs.clear();
+  return complete;
+}
+
+} // namespace triggeralgs
@@ -14,61 +14,86 @@ namespace triggeralgs {
 //---
 void
 TAWindow::add(const TriggerActivity& input_ta)
+{
+  add(TriggerActivity(input_ta));
+}
+
+void
+TAWindow::add(TriggerActivity&& input_ta, const ActivityRef& ref)
 {
 
   adc_integral += input_ta.adc_integral;
-  for (TriggerPrimitive tp : input_ta.inputs) {
-    channel_states[tp.channel]++;
+  for (const TriggerPrimitive& tp : input_ta.inputs) {
+    if (channel_states[tp.channel]++ == 0)
+      n_channels++;
   }
   // Perform binary search based on time_start.
   uint16_t insert_at = 0;
-  for (auto ta : inputs) {
+  for (const auto& ta : inputs) {
     if (input_ta.time_start < ta.time_start)
       break;
     insert_at++;
   }
-  inputs.insert(inputs.begin() + insert_at, input_ta);
+  inputs.insert(inputs.begin() + insert_at, std::move(input_ta));
+  refs.insert(refs.begin() + insert_at, ref);
 }
 
 //---
 void
 TAWindow::clear()
 {
+  clear_channel_states();
   inputs.clear();
-  channel_states.clear();
+  refs.clear();
   time_start = 0;
   adc_integral = 0;
 };
 
+void
+TAWindow::clear_channel_states()
+{
+  // Zero the counts rather than erasing them, so that a channel's entry is only ever allocated
+  // the first time the channel is hit.
+  for (const auto& ta : inputs)
+    for (const TriggerPrimitive& tp : ta.inputs)
+      channel_states[tp.channel] = 0;
+  n_channels = 0;
+}
+
 //---
 void
 TAWindow::move(TriggerActivity const& input_ta, timestamp_t const& window_length)
+{
+  move(TriggerActivity(input_ta), window_length);
+}
+
+void
+TAWindow::move(TriggerActivity&& input_ta, timestamp_t const& window_length, const ActivityRef& ref)
 {
   uint32_t n_tas_to_erase = 0;
-  for (auto ta : inputs) {
+  for (const auto& ta : inputs) {
     if (!(input_ta.time_start - ta.time_start < window_length)) {
       n_tas_to_erase++;
       adc_integral -= ta.adc_integral;
-      for (TriggerPrimitive tp : ta.inputs) {
-        channel_states[tp.channel]--;
+      for (const TriggerPrimitive& tp : ta.inputs) {
         // If a TA being removed from the window results in a channel no longer having
-        // any hits, remove from the states map so map.size() can be used for number
-        // channel hits.
-        if (channel_states[tp.channel] == 0)
-          channel_states.erase(tp.channel);
+        // any hits, it no longer counts towards the number of channels hit.
+        if (--channel_states[tp.channel] == 0)
+          n_channels--;
       }
     } else
       break;
   }
   // Erase the TAs from the window.
   inputs.erase(inputs.begin(), inputs.begin() + n_tas_to_erase);
+  refs.erase(refs.begin(), refs.begin() + n_tas_to_erase);
   // Make the window start time the start time of what is now the
   // first TA.
   if (inputs.size() != 0) {
     time_start = inputs.front().time_start;
-    add(input_ta);
+    add(std::move(input_ta), ref);
   } else {
-    reset(input_ta);
+    reset(std::move(input_ta), ref);
   }
   // add(input_ta);
   // time_start = inputs.front().time_start;
@@ -77,21 +102,30 @@ TAWindow::move(TriggerActivity const& input_ta, timestamp_t const& window_length
 //---
 void
 TAWindow::reset(TriggerActivity const& input_ta)
+{
+  reset(TriggerActivity(input_ta));
+}
+
+void
+TAWindow::reset(TriggerActivity&& input_ta, const ActivityRef& ref)
 {
   // Empty the channel and TA lists.
-  channel_states.clear();
+  clear_channel_states();
   inputs.clear();
+  refs.clear();
   // Set the start time of the window to be the start time of the
   // input_ta.
   time_start = input_ta.time_start;
   // Start the total ADC integral.
   adc_integral = input_ta.adc_integral;
   // Start hit count for the hit channels.
-  for (TriggerPrimitive tp : input_ta.inputs) {
-    channel_states[tp.channel]++;
+  for (const TriggerPrimitive& tp : input_ta.inputs) {
+    if (channel_states[tp.channel]++ == 0)
+      n_channels++;
   }
   // Add the input TA to the TA list.
-  inputs.push_back(input_ta);
+  inputs.push_back(std::move(input_ta));
+  refs.push_back(ref);
 }
 
 std::ostream&
@@ -102,7 +136,7 @@ operator<<(std::ostream& os, const TAWindow& window)
   else {
     os << "Window start: " << window.time_start << ", end: " << window.inputs.back().time_start;
     os << ". Total of: " << window.adc_integral << " ADC counts with " << window.inputs.size() << " TPs.\n";
-    os << window.channel_states.size() << " independent channels have hits.\n";
+    os << window.n_channels << " independent channels have hits.\n";
   }
   return os;
 };
@@ -0,0 +1,383 @@
+/**
+ * @file TPCapture.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPCapture.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace triggeralgs {
+
+namespace {
+
+// Fixed-size parts of the file, written as they are in memory (so little-endian on every
+// machine we run on).
+const char kFileMagic[8] = { 'T', 'P', 'C', 'A', 'P', 'v', '1', '\0' };
+const char kIndexMagic[8] = { 'T', 'P', 'C', 'A', 'P', 'I', 'D', 'X' };
+const uint32_t kBlockMagic = 0x4b425054; // "TPBK"
+// Each TP has at least a one byte varint in each of its six per-TP columns.
+const uint32_t kMinBytesPerTP = 6;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t block_size;
+  uint32_t reserved;
+};
+
+struct BlockHeader
+{
+  uint32_t magic;
+  uint32_t n_tps;
+  uint32_t nbytes;
+  uint32_t reserved;
+  timestamp_t time_first;
+  timestamp_t time_max;
+};
+
+struct Trailer
+{
+  uint64_t index_offset;
+  char magic[8];
+};
+
+void
+put_varint(std::vector<uint8_t>& out, uint64_t value)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+// Small differences of either sign map to small unsigned values: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+uint64_t
+zigzag(uint64_t difference)
+{
+  return (difference << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(difference) >> 63);
+}
+
+uint64_t
+unzigzag(uint64_t value)
+{
+  return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+class VarintReader
+{
+public:
+  VarintReader(const uint8_t* begin, const uint8_t* end)
+    : m_p(begin)
+    , m_end(end)
+  {}
+
+  uint64_t next()
+  {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && m_p != m_end; shift += 7) {
+      uint8_t byte = *m_p++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+    m_ok = false;
+    return 0;
+  }
+
+  bool ok() const { return m_ok; }
+  bool at_end() const { return m_p == m_end; }
+
+private:
+  const uint8_t* m_p;
+  const uint8_t* m_end;
+  bool m_ok = true;
+};
+
+// A column that hardly changes, as (value, run length) pairs.
+template<typename Get>
+void
+put_runs(std::vector<uint8_t>& out, const std::vector<TriggerPrimitive>& tps, Get get)
+{
+  size_t i = 0;
+  while (i < tps.size()) {
+    uint64_t value = get(tps[i]);
+    size_t j = i + 1;
+    while (j < tps.size() && get(tps[j]) == value)
+      ++j;
+    put_varint(out, value);
+    put_varint(out, j - i);
+    i = j;
+  }
+}
+
+template<typename Set>
+bool
+get_runs(VarintReader& in, std::vector<TriggerPrimitive>& tps, Set set)
+{
+  size_t i = 0;
+  while (i < tps.size()) {
+    uint64_t value = in.next();
+    uint64_t length = in.next();
+    if (!in.ok() || length == 0 || length > tps.size() - i)
+      return false;
+    for (; length > 0; --length)
+      set(tps[i++], value);
+  }
+  return true;
+}
+
+template<typename T>
+bool
+read_raw(std::ifstream& file, T& value)
+{
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template<typename T>
+void
+write_raw(std::ofstream& file, const T& value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+bool
+TPCaptureWriter::open(const std::string& path, uint32_t block_size)
+{
+  close();
+  m_block_size = std::max<uint32_t>(block_size, 1);
+  m_block.clear();
+  m_block.reserve(m_block_size);
+  m_index.clear();
+  m_n_tps = 0;
+
+  m_file.clear();
+  m_file.open(path, std::ios::binary | std::ios::trunc);
+  FileHeader header{};
+  std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.block_size = m_block_size;
+  write_raw(m_file, header);
+  m_offset = sizeof(header);
+  return m_file.good();
+}
+
+void
+TPCaptureWriter::write_block()
+{
+  if (m_block.empty())
+    return;
+
+  m_encoded.clear();
+  timestamp_t previous_time = m_block.front().time_start;
+  timestamp_t time_max = previous_time;
+  for (const auto& tp : m_block) {
+    put_varint(m_encoded, zigzag(tp.time_start - previous_time));
+    previous_time = tp.time_start;
+    time_max = std::max(time_max, tp.time_start);
+  }
+  for (const auto& tp : m_block)
+    put_varint(m_encoded, zigzag(tp.time_peak - tp.time_start));
+  for (const auto& tp : m_block)
+    put_varint(m_encoded, tp.time_over_threshold);
+  channel_t previous_channel = 0;
+  for (const auto& tp : m_block) {
+    put_varint(m_encoded, zigzag(static_cast<uint64_t>(tp.channel) - previous_channel));
+    previous_channel = tp.channel;
+  }
+  for (const auto& tp : m_block)
+    put_varint(m_encoded, tp.adc_integral);
+  for (const auto& tp : m_block)
+    put_varint(m_encoded, tp.adc_peak);
+  put_runs(m_encoded, m_block, [](const TriggerPrimitive& tp) { return static_cast<uint64_t>(tp.detid); });
+  put_runs(m_encoded, m_block, [](const TriggerPrimitive& tp) { return static_cast<uint64_t>(tp.type); });
+  put_runs(m_encoded, m_block, [](const TriggerPrimitive& tp) { return static_cast<uint64_t>(tp.algorithm); });
+  put_runs(m_encoded, m_block, [](const TriggerPrimitive& tp) { return static_cast<uint64_t>(tp.version); });
+  put_runs(m_encoded, m_block, [](const TriggerPrimitive& tp) { return static_cast<uint64_t>(tp.flag); });
+
+  BlockHeader header{};
+  header.magic = kBlockMagic;
+  header.n_tps = m_block.size();
+  header.nbytes = m_encoded.size();
+  header.time_first = m_block.front().time_start;
+  header.time_max = time_max;
+  write_raw(m_file, header);
+  m_file.write(reinterpret_cast<const char*>(m_encoded.data()), m_encoded.size());
+
+  m_index.push_back({ m_offset, header.n_tps, header.nbytes, header.time_first, header.time_max });
+  m_offset += sizeof(header) + m_encoded.size();
+  m_n_tps += m_block.size();
+  m_block.clear();
+}
+
+bool
+TPCaptureWriter::close()
+{
+  if (!m_file.is_open())
+    return true;
+
+  write_block();
+  Trailer trailer{};
+  trailer.index_offset = m_offset;
+  std::memcpy(trailer.magic, kIndexMagic, sizeof(kIndexMagic));
+  uint64_t n_blocks = m_index.size();
+  write_raw(m_file, n_blocks);
+  m_file.write(reinterpret_cast<const char*>(m_index.data()), m_index.size() * sizeof(TPCaptureBlockInfo));
+  write_raw(m_file, trailer);
+  m_offset += sizeof(n_blocks) + m_index.size() * sizeof(TPCaptureBlockInfo) + sizeof(trailer);
+
+  bool good = m_file.good();
+  m_file.close();
+  return good;
+}
+
+bool
+TPCaptureReader::open(const std::string& path)
+{
+  m_index.clear();
+  m_time_max_so_far.clear();
+  m_n_tps = 0;
+
+  m_file.close();
+  m_file.clear();
+  m_file.open(path, std::ios::binary);
+  FileHeader header;
+  if (!read_raw(m_file, header) || std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0)
+    return false;
+
+  if (!read_index() && !scan_blocks())
+    return false;
+
+  for (const auto& block : m_index) {
+    m_n_tps += block.n_tps;
+    m_time_max_so_far.push_back(
+      m_time_max_so_far.empty() ? block.time_max : std::max(m_time_max_so_far.back(), block.time_max));
+  }
+  return true;
+}
+
+bool
+TPCaptureReader::read_index()
+{
+  m_file.clear();
+  m_file.seekg(0, std::ios::end);
+  uint64_t file_size = m_file.tellg();
+  if (file_size < sizeof(FileHeader) + sizeof(uint64_t) + sizeof(Trailer))
+    return false;
+
+  Trailer trailer;
+  uint64_t n_blocks = 0;
+  m_file.seekg(file_size - sizeof(Trailer));
+  if (!read_raw(m_file, trailer) || std::memcmp(trailer.magic, kIndexMagic, sizeof(kIndexMagic)) != 0)
+    return false;
+  m_file.seekg(trailer.index_offset);
+  if (trailer.index_offset > file_size || !read_raw(m_file, n_blocks) ||
+      n_blocks * sizeof(TPCaptureBlockInfo) != file_size - sizeof(Trailer) - sizeof(uint64_t) - trailer.index_offset)
+    return false;
+
+  m_index.resize(n_blocks);
+  if (!m_file.read(reinterpret_cast<char*>(m_index.data()), n_blocks * sizeof(TPCaptureBlockInfo))) {
+    m_index.clear();
+    return false;
+  }
+
+  // read_block() trusts the index, so each block must lie between the header and the index.
+  // If one doesn't, the index is corrupt and the blocks are scanned instead.
+  for (const auto& block : m_index) {
+    if (block.offset < sizeof(FileHeader) || block.offset > trailer.index_offset ||
+        block.nbytes > trailer.index_offset - block.offset ||
+        trailer.index_offset - block.offset - block.nbytes < sizeof(BlockHeader)) {
+      m_index.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+TPCaptureReader::scan_blocks()
+{
+  // No index, so the writer stopped early: take every complete block there is.
+  m_file.clear();
+  m_file.seekg(0, std::ios::end);
+  uint64_t file_size = m_file.tellg();
+  uint64_t offset = sizeof(FileHeader);
+  m_index.clear();
+
+  BlockHeader header;
+  while (offset + sizeof(header) <= file_size) {
+    m_file.seekg(offset);
+    if (!read_raw(m_file, header) || header.magic != kBlockMagic ||
+        header.nbytes > file_size - offset - sizeof(header) || header.n_tps > header.nbytes / kMinBytesPerTP)
+      break;
+    m_index.push_back({ offset, header.n_tps, header.nbytes, header.time_first, header.time_max });
+    offset += sizeof(header) + header.nbytes;
+  }
+  m_file.clear();
+  return true;
+}
+
+size_t
+TPCaptureReader::find_block(timestamp_t time) const
+{
+  // Blocks before the first whose running maximum reaches `time` can only hold earlier TPs.
+  return std::lower_bound(m_time_max_so_far.begin(), m_time_max_so_far.end(), time) - m_time_max_so_far.begin();
+}
+
+bool
+TPCaptureReader::read_block(size_t index, std::vector<TriggerPrimitive>& tps)
+{
+  if (index >= m_index.size())
+    return false;
+
+  // A corrupt count mustn't make us allocate far more TPs than the block could hold.
+  const TPCaptureBlockInfo& block = m_index[index];
+  if (block.n_tps > block.nbytes / kMinBytesPerTP)
+    return false;
+  m_encoded.resize(block.nbytes);
+  m_file.clear();
+  m_file.seekg(block.offset + sizeof(BlockHeader));
+  if (!m_file.read(reinterpret_cast<char*>(m_encoded.data()), block.nbytes))
+    return false;
+
+  tps.resize(block.n_tps);
+  VarintReader in(m_encoded.data(), m_encoded.data() + m_encoded.size());
+  timestamp_t time = block.time_first;
+  for (auto& tp : tps) {
+    time += unzigzag(in.next());
+    tp.time_start = time;
+  }
+  for (auto& tp : tps)
+    tp.time_peak = tp.time_start + unzigzag(in.next());
+  for (auto& tp : tps)
+    tp.time_over_threshold = in.next();
+  uint64_t channel = 0;
+  for (auto& tp : tps) {
+    channel += unzigzag(in.next());
+    tp.channel = static_cast<channel_t>(channel);
+  }
+  for (auto& tp : tps)
+    tp.adc_integral = in.next();
+  for (auto& tp : tps)
+    tp.adc_peak = in.next();
+
+  using Type = TriggerPrimitive::Type;
+  using Algorithm = TriggerPrimitive::Algorithm;
+  bool ok = in.ok() &&
+            get_runs(in, tps, [](TriggerPrimitive& tp, uint64_t v) { tp.detid = v; }) &&
+            get_runs(in, tps, [](TriggerPrimitive& tp, uint64_t v) { tp.type = static_cast<Type>(v); }) &&
+            get_runs(in, tps, [](TriggerPrimitive& tp, uint64_t v) { tp.algorithm = static_cast<Algorithm>(v); }) &&
+            get_runs(in, tps, [](TriggerPrimitive& tp, uint64_t v) { tp.version = v; }) &&
+            get_runs(in, tps, [](TriggerPrimitive& tp, uint64_t v) { tp.flag = v; }) && in.at_end();
+  if (!ok)
+    tps.clear();
+  return ok;
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,21 @@
+/**
+ * @file TPReorderBuffer.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPReorderBuffer.hpp"
+
+namespace triggeralgs {
+
+TPReorderBuffer::TPReorderBuffer(timestamp_t horizon, timestamp_t bucket_width)
+  : m_horizon(horizon)
+  , m_bucket_width(std::max<timestamp_t>(bucket_width, 1))
+{
+  // A held TP is never more than horizon + one bucket ahead of the oldest unreleased bucket.
+  m_buckets.resize(m_horizon / m_bucket_width + 2);
+}
+
+} // namespace triggeralgs
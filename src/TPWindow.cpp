@@ -22,15 +22,16 @@ TPWindow::add(TriggerPrimitive const& input_tp)
   // Add the input TP's contribution to the total ADC, increase hit
   // channel's hit count and add it to the TP list.
   adc_integral += input_tp.adc_integral;
-  channel_states[input_tp.channel]++;
+  if (channel_states[input_tp.channel]++ == 0)
+    n_channels++;
   inputs.push_back(input_tp);
 }
 
 void
 TPWindow::clear()
 {
+  clear_channel_states();
   inputs.clear();
-  channel_states.clear();
   time_start = 0;
   adc_integral = 0;
 }
@@ -38,7 +39,17 @@ TPWindow::clear()
 uint16_t
 TPWindow::n_channels_hit()
 {
-  return channel_states.size();
+  return n_channels;
+}
+
+void
+TPWindow::clear_channel_states()
+{
+  // Zero the counts rather than erasing them, so that a channel's entry is only ever allocated
+  // the first time the channel is hit.
+  for (const auto& tp : inputs)
+    channel_states[tp.channel] = 0;
+  n_channels = 0;
 }
 
 void
@@ -54,12 +65,10 @@ TPWindow::move(TriggerPrimitive const& input_tp, timestamp_t const& window_lengt
     if (!(input_tp.time_start - tp.time_start < window_length)) {
       n_tps_to_erase++;
       adc_integral -= tp.adc_integral;
-      channel_states[tp.channel]--;
       // If a TP being removed from the window results in a channel no longer having
-      // any hits, remove from the states map so map.size() can be used for number
-      // channels hit.
-      if (channel_states[tp.channel] == 0)
-        channel_states.erase(tp.channel);
+      // any hits, it no longer counts towards the number of channels hit.
+      if (--channel_states[tp.channel] == 0)
+        n_channels--;
     } else
       break;
   }
@@ -80,7 +89,7 @@ TPWindow::reset(TriggerPrimitive const& input_tp)
 {
 
   // Empty the channel and TP lists.
-  channel_states.clear();
+  clear_channel_states();
   inputs.clear();
   // Set the start time of the window to be the start time of theinput_tp.
   time_start = input_tp.time_start;
@@ -88,6 +97,7 @@ TPWindow::reset(TriggerPrimitive const& input_tp)
   adc_integral = input_tp.adc_integral;
   // Start hit count for the hit channel.
   channel_states[input_tp.channel]++;
+  n_channels = 1;
   // Add the input TP to the TP list.
   inputs.push_back(input_tp);
   // std::cout << "Number of channels hit: " << n_channels_hit() << std::endl;
@@ -101,7 +111,7 @@ operator<<(std::ostream& os, const TPWindow& window)
   } else {
     os << "Window start: " << window.time_start << ", end: " << window.inputs.back().time_start;
     os << ". Total of: " << window.adc_integral << " ADC counts with " << window.inputs.size() << " TPs.\n";
-    os << window.channel_states.size() << " independent channels have hits.\n";
+    os << window.n_channels << " independent channels have hits.\n";
   }
   return os;
 }
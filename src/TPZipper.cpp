@@ -0,0 +1,69 @@
+/**
+ * @file TPZipper.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPZipper.hpp"
+
+namespace triggeralgs {
+
+TPZipper::TPZipper(size_t n_links, timestamp_t max_latency, size_t link_capacity)
+  : m_links(std::max<size_t>(n_links, 1))
+  , m_max_latency(max_latency)
+{
+  for (auto& link : m_links)
+    link.ring.resize(std::max<size_t>(link_capacity, 1));
+  m_heap.reserve(m_links.size());
+}
+
+bool
+TPZipper::is_late(size_t link) const
+{
+  return m_newest - m_links[link].watermark > m_max_latency;
+}
+
+bool
+TPZipper::push(size_t link, const TriggerPrimitive& input_tp)
+{
+  Link& queue = m_links[link];
+  if (queue.size == queue.ring.size())
+    return false;
+
+  queue.ring[(queue.head + queue.size) % queue.ring.size()] = input_tp;
+  if (queue.size++ == 0) {
+    m_heap.push_back({ input_tp.time_start, link });
+    std::push_heap(m_heap.begin(), m_heap.end());
+  }
+  return true;
+}
+
+void
+TPZipper::advance_watermark(size_t link, timestamp_t time)
+{
+  timestamp_t& watermark = m_links[link].watermark;
+  if (time <= watermark)
+    return;
+
+  // Only rescan the links when the one holding the minimum moves.
+  bool was_min = watermark == m_min_watermark;
+  watermark = time;
+  m_newest = std::max(m_newest, time);
+  if (was_min) {
+    m_min_watermark = m_links.front().watermark;
+    for (auto& other : m_links)
+      m_min_watermark = std::min(m_min_watermark, other.watermark);
+  }
+}
+
+timestamp_t
+TPZipper::safe_time() const
+{
+  // Links lagging by more than the maximum latency don't hold the output back.
+  timestamp_t latency_bound = m_newest > m_max_latency ? m_newest - m_max_latency : 0;
+  return std::max(m_min_watermark, latency_bound);
+}
+
+} // namespace triggeralgs
@@ -11,6 +11,7 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerActivityMakerADCSimpleWindowPlugin"
 
+#include <algorithm>
 #include <vector>
 
 
@@ -19,15 +20,34 @@ using Logging::TLVL_DEBUG_ALL;
 using Logging::TLVL_DEBUG_HIGH;
 using Logging::TLVL_DEBUG_LOW;
 using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
 
 void
 TriggerActivityMakerADCSimpleWindow::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
 {
+  VectorSink<TriggerActivity> sink(output_ta);
+  (*this)(input_tp, sink);
+}
+
+void
+TriggerActivityMakerADCSimpleWindow::operator()(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta)
+{
+  MakerMetrics::Scope scope(m_metrics);
+  m_metrics.record_arrival(input_tp.time_start);
+
+  // In bucketed mode every configured window is checked on every TP, see process_bucketed().
+  if(m_bucket_width > 0){
+    process_bucketed(input_tp, output_ta);
+    m_metrics.set_occupancy(m_bucket_window.size());
+    m_primitive_count++;
+    return;
+  }
   
   // The first time operator is called, reset
   // window object.
   if(m_current_window.is_empty()){
     m_current_window.reset(input_tp);
+    m_metrics.set_occupancy(m_current_window.tp_list.size());
     m_primitive_count++;
     return;
   } 
@@ -35,7 +55,7 @@ TriggerActivityMakerADCSimpleWindow::operator()(const TriggerPrimitive& input_tp
   // If the difference between the current TP's start time and the start of the window
   // is less than the specified window size, add the TP to the window.
   if((input_tp.time_start - m_current_window.time_start) < m_window_length){
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TAM:ADCSW] Window not yet complete, adding the input_tp to the window.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TAM:ADCSW] Window not yet complete, adding the input_tp to the window.";
     m_current_window.add(input_tp);
   }
   // If the addition of the current TP to the window would make it longer
@@ -43,24 +63,55 @@ TriggerActivityMakerADCSimpleWindow::operator()(const TriggerPrimitive& input_tp
   // the existing window is above the specified threshold. If it is, make a TA and start 
   // a fresh window with the current TP.
   else if(m_current_window.adc_integral > m_adc_threshold){
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] ADC integral in window is greater than specified threshold.";
-    output_ta.push_back(construct_ta());
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TAM:ADCSW] Resetting window with input_tp.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] ADC integral in window is greater than specified threshold.";
+    m_metrics.count_trigger();
+    m_metrics.record_latency(input_tp.time_start, m_current_window.tp_list);
+    output_ta.emit(construct_ta());
+    m_metrics.count_outputs();
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TAM:ADCSW] Resetting window with input_tp.";
     m_current_window.reset(input_tp);
   }
   // If it is not, move the window along.
   else{
-    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:ADCSW] Window is at required length but adc threshold not met, shifting window along.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:ADCSW] Window is at required length but adc threshold not met, shifting window along.";
     m_current_window.move(input_tp, m_window_length);
   }
   
-  TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:ADCSW] " << m_current_window;
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:ADCSW] " << m_current_window;
 
+  m_metrics.set_occupancy(m_current_window.tp_list.size());
   m_primitive_count++;
 
   return;
 }
 
+void
+TriggerActivityMakerADCSimpleWindow::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  VectorSink<TriggerActivity> sink(output_ta);
+  flush(until, sink);
+}
+
+void
+TriggerActivityMakerADCSimpleWindow::flush(timestamp_t until, OutputSink<TriggerActivity>& output_ta)
+{
+  // Bucketed windows are checked as each TP arrives, so there is never anything held back.
+  if(m_bucket_width > 0 || m_current_window.is_empty()) return;
+
+  // Any TP at or after until would close the window: do what it would do, leaving the window
+  // empty so that TP starts a new one.
+  if(until < m_current_window.time_start + m_window_length) return;
+  if(m_current_window.adc_integral > m_adc_threshold){
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] ADC integral in flushed window is greater than specified threshold.";
+    m_metrics.count_trigger();
+    m_metrics.record_latency(until, m_current_window.tp_list);
+    output_ta.emit(construct_ta());
+    m_metrics.count_outputs();
+    m_current_window.clear();
+    m_metrics.set_occupancy(0);
+  }
+}
+
 void
 TriggerActivityMakerADCSimpleWindow::configure(const nlohmann::json &config)
 {
@@ -68,18 +119,69 @@ TriggerActivityMakerADCSimpleWindow::configure(const nlohmann::json &config)
   if (config.is_object()){
     if (config.contains("window_length")) m_window_length = config["window_length"];
     if (config.contains("adc_threshold")) m_adc_threshold = config["adc_threshold"];
+    if (config.contains("bucket_width")) m_bucket_width = config["bucket_width"];
+    if (config.contains("window_lengths")) m_window_lengths = config["window_lengths"].get<std::vector<timestamp_t>>();
+    if (config.contains("adc_thresholds")) m_adc_thresholds = config["adc_thresholds"].get<std::vector<uint64_t>>();
   }
   else{
-    TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:ADCSW] The DEFAULT values of window_length and adc_threshold are being used.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:ADCSW] The DEFAULT values of window_length and adc_threshold are being used.";
+  }
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:ADCSW] If the total ADC of trigger primitives with times within a "
+                                     << m_window_length << " tick time window is above " << m_adc_threshold << " counts, a trigger will be issued.";
+
+  if(m_bucket_width == 0) return;
+
+  // Bucketed mode: each window length is rounded down to a whole number of buckets.
+  if(m_window_lengths.empty()) m_window_lengths.push_back(m_window_length);
+  if(m_adc_thresholds.size() != m_window_lengths.size()){
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:ADCSW] Got " << m_adc_thresholds.size() << " adc_thresholds for "
+                                                << m_window_lengths.size() << " window_lengths, using adc_threshold for the rest.";
+    m_adc_thresholds.resize(m_window_lengths.size(), m_adc_threshold);
+  }
+  m_window_buckets.clear();
+  m_window_thresholds.clear();
+  int64_t max_buckets = 1;
+  for(size_t i = 0; i < m_window_lengths.size(); ++i){
+    int64_t n_buckets = std::max<int64_t>(1, m_window_lengths[i] / m_bucket_width);
+    m_window_buckets.push_back(n_buckets);
+    m_window_thresholds.push_back(m_adc_thresholds[i]);
+    max_buckets = std::max(max_buckets, n_buckets);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:ADCSW] Bucketed window " << i << ": " << n_buckets << " x " << m_bucket_width
+                                           << " ticks, threshold " << m_adc_thresholds[i] << " ADC counts.";
+  }
+  m_bucket_window.configure(m_bucket_width, max_buckets);
+}
+
+void
+TriggerActivityMakerADCSimpleWindow::process_bucketed(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta)
+{
+  // Unlike the TP window, a bucketed window is checked as soon as a TP lands in it, and the
+  // TA includes that TP. After a TA, all windows start again empty.
+  if(!m_bucket_window.add(input_tp)){
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] Dropping TP at " << input_tp.time_start << ", before the current bucket.";
+    m_metrics.count_drops();
+    return;
+  }
+  for(size_t i = 0; i < m_window_buckets.size(); ++i){
+    uint64_t adc_integral = m_bucket_window.adc_integral(m_window_buckets[i]);
+    if(adc_integral > m_window_thresholds[i]){
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] ADC integral in bucketed window " << i << " is greater than specified threshold.";
+      // Each configured window length counts as its own trigger condition.
+      m_metrics.count_trigger(i);
+      TriggerActivity ta = construct_bucketed_ta(adc_integral, m_window_buckets[i]);
+      m_metrics.record_latency(input_tp.time_start, ta.inputs);
+      output_ta.emit(std::move(ta));
+      m_metrics.count_outputs();
+      m_bucket_window.reset();
+      return;
+    }
   }
-  TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:ADCSW] If the total ADC of trigger primitives with times within a "
-                         << m_window_length << " tick time window is above " << m_adc_threshold << " counts, a trigger will be issued.";
 }
 
 TriggerActivity
 TriggerActivityMakerADCSimpleWindow::construct_ta() const
 {
-  TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] I am constructing a trigger activity!";
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] I am constructing a trigger activity!";
   //TLOG_DEBUG(TRACE_NAME) << m_current_window;
 
   TriggerPrimitive latest_tp_in_window = m_current_window.tp_list.back();
@@ -102,5 +204,112 @@ TriggerActivityMakerADCSimpleWindow::construct_ta() const
   return ta;
 }
 
+TriggerActivity
+TriggerActivityMakerADCSimpleWindow::construct_bucketed_ta(uint64_t adc_integral, int64_t n_buckets) const
+{
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] I am constructing a trigger activity!";
+
+  TriggerActivity ta;
+  m_bucket_window.fill_inputs(n_buckets, ta.inputs);
+
+  const TriggerPrimitive& latest_tp_in_window = ta.inputs.back();
+  ta.time_start = ta.inputs.front().time_start;
+  ta.time_end = latest_tp_in_window.time_start + latest_tp_in_window.time_over_threshold;
+  ta.time_peak = latest_tp_in_window.time_peak;
+  ta.time_activity = latest_tp_in_window.time_peak;
+  ta.channel_start = latest_tp_in_window.channel;
+  ta.channel_end = latest_tp_in_window.channel;
+  ta.channel_peak = latest_tp_in_window.channel;
+  ta.adc_integral = adc_integral;
+  ta.adc_peak = latest_tp_in_window.adc_peak;
+  ta.detid = latest_tp_in_window.detid;
+  ta.type = TriggerActivity::Type::kTPC;
+  ta.algorithm = TriggerActivity::Algorithm::kADCSimpleWindow;
+  return ta;
+}
+
+void
+TriggerActivityMakerADCSimpleWindow::BucketWindow::configure(timestamp_t bucket_width, int64_t max_buckets)
+{
+  m_bucket_width = bucket_width;
+  m_max_buckets = max_buckets;
+  // One extra slot holds the running sum just before the longest window.
+  m_prefix_sums.assign(max_buckets + 1, 0);
+  reset();
+}
+
+bool
+TriggerActivityMakerADCSimpleWindow::BucketWindow::add(TriggerPrimitive const &input_tp)
+{
+  const int64_t n_slots = m_prefix_sums.size();
+  int64_t bucket = input_tp.time_start / m_bucket_width;
+  // The running sums of earlier buckets are already fixed, so a TP that belongs in one of
+  // them can't be counted where fill_inputs() would look for it.
+  if(!m_empty && bucket < m_current_bucket) return false;
+
+  uint64_t total = m_empty ? m_base_sum : m_prefix_sums[m_current_bucket % n_slots];
+
+  if(m_empty){
+    // Start again from this bucket: anything before it reads as the current running sum.
+    m_empty = false;
+    m_base_bucket = bucket;
+    m_current_bucket = bucket;
+  }
+  else if(bucket > m_current_bucket){
+    // Buckets skipped over are empty, so carry the running sum into them. Only the last
+    // n_slots of them can ever be read.
+    for(int64_t b = std::max(m_current_bucket + 1, bucket - n_slots + 1); b <= bucket; ++b){
+      m_prefix_sums[b % n_slots] = total;
+    }
+    m_current_bucket = bucket;
+  }
+
+  total += input_tp.adc_integral;
+  m_prefix_sums[m_current_bucket % n_slots] = total;
+  m_tp_buffer.push_back(input_tp);
+
+  // Drop TPs that have left the longest window.
+  while(!m_tp_buffer.empty() &&
+        static_cast<int64_t>(m_tp_buffer.front().time_start / m_bucket_width) <= m_current_bucket - m_max_buckets){
+    m_tp_buffer.pop_front();
+  }
+  return true;
+}
+
+uint64_t
+TriggerActivityMakerADCSimpleWindow::BucketWindow::prefix(int64_t bucket) const
+{
+  // Running sum up to and including `bucket`, not counting anything from before the last reset.
+  if(bucket < m_base_bucket) return m_base_sum;
+  return m_prefix_sums[bucket % static_cast<int64_t>(m_prefix_sums.size())];
+}
+
+uint64_t
+TriggerActivityMakerADCSimpleWindow::BucketWindow::adc_integral(int64_t n_buckets) const
+{
+  if(m_empty) return 0;
+  return prefix(m_current_bucket) - prefix(m_current_bucket - n_buckets);
+}
+
+void
+TriggerActivityMakerADCSimpleWindow::BucketWindow::fill_inputs(int64_t n_buckets, std::vector<TriggerPrimitive> &inputs) const
+{
+  // The TP buffer is time ordered, so the window is a tail of it.
+  auto first = m_tp_buffer.end();
+  while(first != m_tp_buffer.begin() &&
+        static_cast<int64_t>((first - 1)->time_start / m_bucket_width) > m_current_bucket - n_buckets){
+    --first;
+  }
+  inputs.insert(inputs.end(), first, m_tp_buffer.end());
+}
+
+void
+TriggerActivityMakerADCSimpleWindow::BucketWindow::reset()
+{
+  if(!m_empty) m_base_sum = m_prefix_sums[m_current_bucket % static_cast<int64_t>(m_prefix_sums.size())];
+  m_empty = true;
+  m_tp_buffer.clear();
+}
+
 // Register algo in TA Factory
 REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, TriggerActivityMakerADCSimpleWindow)
@@ -55,7 +55,7 @@ TriggerActivityMakerBundleN::operator()(const TriggerPrimitive& input_tp, std::v
   m_current_ta.inputs.push_back(input_tp);
 
   if (bundle_condition()) {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TA:BN] Emitting BundleN TA with " << m_current_ta.inputs.size() << " TPs.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TA:BN] Emitting BundleN TA with " << m_current_ta.inputs.size() << " TPs.";
     set_ta_attributes();
     output_tas.push_back(m_current_ta);
 
@@ -65,7 +65,7 @@ TriggerActivityMakerBundleN::operator()(const TriggerPrimitive& input_tp, std::v
 
   // Should never reach this step. In this case, send it out.
   if (m_current_ta.inputs.size() > m_bundle_size) {
-    TLOG_DEBUG(TLVL_IMPORTANT) << "[TA:BN] Emitting large BundleN TriggerActivity with " << m_current_ta.inputs.size() << " TPs.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TA:BN] Emitting large BundleN TriggerActivity with " << m_current_ta.inputs.size() << " TPs.";
     set_ta_attributes();
     output_tas.push_back(m_current_ta);
 
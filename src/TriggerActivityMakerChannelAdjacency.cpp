@@ -10,6 +10,7 @@
 #include "TRACE/trace.h"
 #include "dunetrigger/triggeralgs/include/triggeralgs/Logging.hpp"
 #define TRACE_NAME "TriggerActivityMakerChannelAdjacencyPlugin"
+#include <algorithm>
 #include <math.h>
 #include <vector>
 
@@ -21,80 +22,89 @@ void
 TriggerActivityMakerChannelAdjacency::operator()(const TriggerPrimitive& input_tp,
                                                  std::vector<TriggerActivity>& output_ta)
 {
+  MakerMetrics::Scope scope(m_metrics);
 
   // Add useful info about recived TPs here for FW and SW TPG guys.
   if (m_print_tp_info) {
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << " ########## m_current_window is reset ##########\n"
-                               << " TP Start Time: " << input_tp.time_start << ", TP ADC Sum: " << input_tp.adc_integral
-                               << ", TP TOT: " << input_tp.time_over_threshold << ", TP ADC Peak: " << input_tp.adc_peak
-                               << ", TP Offline Channel ID: " << input_tp.channel << "\n";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << " ########## m_current_window is reset ##########\n"
+                                           << " TP Start Time: " << input_tp.time_start << ", TP ADC Sum: " << input_tp.adc_integral
+                                           << ", TP TOT: " << input_tp.time_over_threshold << ", TP ADC Peak: " << input_tp.adc_peak
+                                           << ", TP Offline Channel ID: " << input_tp.channel << "\n";
   }
 
   // 0) FIRST TP =====================================================================
   // The first time operator() is called, reset the window object.
   if (m_current_window.is_empty()) {
     m_current_window.reset(input_tp);
+    m_window_checked = false;
+    m_metrics.set_occupancy(m_current_window.inputs.size());
     return;
   }
 
   // If the difference between the current TP's start time and the start of the window
   // is less than the specified window size, add the TP to the window.
-  bool adj_pass = 0;      // sets to true when adjacency logic is satisfied
-  bool window_filled = 1; // sets to true when window is ready to test the adjacency logic
   if ((input_tp.time_start - m_current_window.time_start) < m_window_length) {
     m_current_window.add(input_tp);
-    window_filled = 0;
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << "m_current_window.time_start " << m_current_window.time_start << "\n";
-  }
-
-  else {
-    TPWindow win_adj_max;
-
-    bool ta_found = 1;
-    while (ta_found) {
-
-      // make m_current_window_tmp a copy of m_current_window and clear m_current_window
-      TPWindow m_current_window_tmp = m_current_window;
-      m_current_window.clear();
-
-      // make m_current_window a new window of non-overlapping tps (of m_current_window_tmp and win_adj_max)
-      for (auto tp : m_current_window_tmp.inputs) {
-        bool new_tp = 1;
-        for (auto tp_sel : win_adj_max.inputs) {
-          if (tp.channel == tp_sel.channel) {
-            new_tp = 0;
-            break;
-          }
-        }
-        if (new_tp)
-          m_current_window.add(tp);
-      }
-
-      // check adjacency -> win_adj_max now contains only those tps that make the track
-      win_adj_max = check_adjacency();
-      if (win_adj_max.inputs.size() > 0) {
-
-        adj_pass = 1;
-        ta_found = 1;
-        m_ta_count++;
-        if (m_ta_count % m_prescale == 0) {
-          output_ta.push_back(construct_ta(win_adj_max));
-        }
-      } else
-        ta_found = 0;
-    }
-    if (adj_pass)
-      m_current_window.reset(input_tp);
+    m_window_checked = false;
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "m_current_window.time_start " << m_current_window.time_start << "\n";
+    m_metrics.set_occupancy(m_current_window.inputs.size());
+    return;
   }
 
-  // if adjacency logic is not true, slide the window along using the current TP.
-  if (window_filled && !adj_pass) {
+  // The window is filled: extract every adjacent track from it in one pass. Tracks never
+  // share a channel, so this gives the same TAs as repeatedly removing the channels of
+  // the last track found and checking the remaining TPs again. If a flush has already
+  // checked this window, m_adjacent_tracks is still empty from then.
+  if (!m_window_checked)
+    check_adjacency();
+  emit_adjacent_tracks(output_ta);
+
+  // If adjacency logic is satisfied start a fresh window with the current TP, otherwise
+  // slide the window along using the current TP.
+  if (!m_adjacent_tracks.empty())
+    m_current_window.reset(input_tp);
+  else
     m_current_window.move(input_tp, m_window_length);
-  }
+  m_window_checked = false;
+  m_metrics.set_occupancy(m_current_window.inputs.size());
 
   return;
 }
 
+void
+TriggerActivityMakerChannelAdjacency::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // Any TP at or after until would fill the window, so check it now. Finding nothing leaves
+  // the window as it is for that TP to slide along.
+  if (m_current_window.is_empty() || m_window_checked || until < m_current_window.time_start + m_window_length)
+    return;
+
+  check_adjacency();
+  emit_adjacent_tracks(output_ta);
+
+  if (!m_adjacent_tracks.empty()) {
+    m_current_window.clear();
+    m_metrics.set_occupancy(0);
+  } else {
+    m_window_checked = true;
+  }
+}
+
+void
+TriggerActivityMakerChannelAdjacency::emit_adjacent_tracks(std::vector<TriggerActivity>& output_ta)
+{
+  for (const auto& track : m_adjacent_tracks) {
+    m_metrics.count_trigger();
+    m_ta_count++;
+    if (m_ta_count % m_prescale == 0) {
+      output_ta.push_back(construct_ta(track.first, track.second));
+      m_metrics.count_outputs();
+    } else {
+      m_metrics.count_drops();
+    }
+  }
+}
+
 void
 TriggerActivityMakerChannelAdjacency::configure(const nlohmann::json& config)
 {
@@ -113,12 +123,20 @@ TriggerActivityMakerChannelAdjacency::configure(const nlohmann::json& config)
 }
 
 TriggerActivity
-TriggerActivityMakerChannelAdjacency::construct_ta(TPWindow win_adj_max) const
+TriggerActivityMakerChannelAdjacency::construct_ta(size_t begin, size_t end) const
 {
 
   TriggerActivity ta;
 
-  TriggerPrimitive last_tp = win_adj_max.inputs.back();
+  // The first channel of a track contributes its last TP, every following channel its
+  // first TP, as that is where the adjacency scan steps onto them.
+  ta.inputs.reserve(end - begin);
+  ta.inputs.push_back(*m_channel_occupancy[begin].last_tp);
+  for (size_t i = begin + 1; i < end; ++i) {
+    ta.inputs.push_back(*m_channel_occupancy[i].first_tp);
+  }
+
+  const TriggerPrimitive& last_tp = ta.inputs.back();
 
   ta.time_start = last_tp.time_start;
   ta.time_end = last_tp.time_start;
@@ -127,18 +145,18 @@ TriggerActivityMakerChannelAdjacency::construct_ta(TPWindow win_adj_max) const
   ta.channel_start = last_tp.channel;
   ta.channel_end = last_tp.channel;
   ta.channel_peak = last_tp.channel;
-  ta.adc_integral = win_adj_max.adc_integral;
+  ta.adc_integral = 0;
   ta.adc_peak = last_tp.adc_peak;
   ta.detid = last_tp.detid;
   ta.type = TriggerActivity::Type::kTPC;
   ta.algorithm = TriggerActivity::Algorithm::kChannelAdjacency;
-  ta.inputs = win_adj_max.inputs;
 
   for (const auto& tp : ta.inputs) {
     ta.time_start = std::min(ta.time_start, tp.time_start);
     ta.time_end = std::max(ta.time_end, tp.time_start);
     ta.channel_start = std::min(ta.channel_start, tp.channel);
     ta.channel_end = std::max(ta.channel_end, tp.channel);
+    ta.adc_integral += tp.adc_integral;
     if (tp.adc_peak > ta.adc_peak) {
       ta.time_peak = tp.time_peak;
       ta.adc_peak = tp.adc_peak;
@@ -149,97 +167,88 @@ TriggerActivityMakerChannelAdjacency::construct_ta(TPWindow win_adj_max) const
   return ta;
 }
 
-// std::vector<TriggerPrimitive>
-TPWindow
+void
 TriggerActivityMakerChannelAdjacency::check_adjacency()
 {
   // This function deals with tp window (m_current_window), select adjacent tps (with a channel gap from 0 to 5; sum of
-  // all gaps < m_adj_tolerance), checks if track length > m_adjacency_threshold: return the tp window (win_adj_max,
-  // which is subset of the input tp window)
-
-  unsigned int channel = 0;      // Current channel ID
-  unsigned int next_channel = 0; // Next channel ID
-  unsigned int next = 0;         // The next position in the hit channels vector
-  unsigned int tol_count = 0;    // Tolerance count, should not pass adj_tolerance
-
-  // Generate a channelID ordered list of hit channels for this window; second element of pair is tps
-  std::vector<std::pair<int, TriggerPrimitive>> chanTPList;
-  for (auto tp : m_current_window.inputs) {
-    chanTPList.push_back(std::make_pair(tp.channel, tp));
+  // all gaps < m_adj_tolerance), and records every track with length > m_adjacency_threshold in m_adjacent_tracks.
+
+  m_adjacent_tracks.clear();
+
+  // Generate a channelID ordered list of the TPs in this window. The sort is stable so TPs
+  // on the same channel stay in window (time) order.
+  m_sorted_tps.clear();
+  for (const auto& tp : m_current_window.inputs) {
+    m_sorted_tps.push_back(&tp);
+  }
+  std::stable_sort(m_sorted_tps.begin(), m_sorted_tps.end(), [](const TriggerPrimitive* a, const TriggerPrimitive* b) {
+    return a->channel < b->channel;
+  });
+
+  // Collapse it into one occupancy entry per hit channel.
+  m_channel_occupancy.clear();
+  for (const TriggerPrimitive* tp : m_sorted_tps) {
+    if (!m_channel_occupancy.empty() && m_channel_occupancy.back().channel == tp->channel)
+      m_channel_occupancy.back().last_tp = tp;
+    else
+      m_channel_occupancy.push_back({ tp->channel, tp, tp });
   }
-  std::sort(chanTPList.begin(),
-            chanTPList.end(),
-            [](const std::pair<int, TriggerPrimitive>& a, const std::pair<int, TriggerPrimitive>& b) {
-              return (a.first < b.first);
-            });
 
   // ADAJACENCY LOGIC ====================================================================
   // =====================================================================================
   // Adjcancency Tolerance = Number of times prepared to skip missed hits before resetting
-  // the adjacency count (win_adj). This accounts for things like dead channels / missed TPs.
-
-  // add first tp, and then if tps are on next channels (check code below to understand the definition)
-  TPWindow win_adj;
-  TPWindow win_adj_max; // if track length > m_adjacency_threshold, set win_adj_max = win_adj; return win_adj_max;
-
-  for (int i = 0; i < chanTPList.size(); ++i) {
+  // the adjacency count (track_length). This accounts for things like dead channels / missed TPs.
 
-    win_adj_max.clear();
+  size_t track_begin = 0;      // Occupancy index of the first channel of the current track
+  size_t track_length = 0;     // Number of channels in the current track
+  unsigned int tol_count = 0;  // Tolerance count, should not pass adj_tolerance
 
-    next = (i + 1) % chanTPList.size(); // Loops back when outside of channel list range
-    channel = chanTPList.at(i).first;
-    next_channel = chanTPList.at(next).first; // Next channel with a hit
+  for (size_t i = 0; i < m_channel_occupancy.size(); ++i) {
 
-    // End of vector condition.
-    if (next == 0) {
-      next_channel = channel - 1;
+    // If the current track is empty, start it on this channel.
+    if (track_length == 0) {
+      track_begin = i;
+      track_length = 1;
     }
 
-    // Skip same channel hits.
-    if (next_channel == channel)
-      continue;
-
-    // If win_adj size == zero, add current tp
-    if (win_adj.inputs.size() == 0)
-      win_adj.add(chanTPList[i].second);
+    // Channel gap to the next hit channel; the last channel never has a next hit.
+    bool has_next = (i + 1 < m_channel_occupancy.size());
+    channel_t gap = has_next ? m_channel_occupancy[i + 1].channel - m_channel_occupancy[i].channel : 0;
 
     // If next hit is on next channel, increment the adjacency count
-    if (next_channel - channel == 1) {
-      win_adj.add(chanTPList[next].second);
+    if (has_next && gap == 1) {
+      track_length++;
     }
 
     // Allow a max gap of 5 channels (e.g., 45 and 50; 46, 47, 48, 49 are missing); increment the adjacency count
     // Sum of gaps should be < adj_tolerance (e.g., if toleance is 30, the max total gap can vary from 0 to 29+4 = 33)
-    else if (next_channel - channel > 0 && next_channel - channel <= 5 && tol_count < m_adj_tolerance) {
-      win_adj.add(chanTPList[next].second);
-      tol_count += next_channel - channel - 1;
-    }
-
-    // if track length > m_adjacency_threshold, set win_adj_max = win_adj;
-    else if (win_adj.inputs.size() > m_adjacency_threshold) {
-      win_adj_max = win_adj;
-      break;
+    else if (has_next && gap <= 5 && tol_count < m_adj_tolerance) {
+      track_length++;
+      tol_count += gap - 1;
     }
 
-    // If track length < m_adjacency_threshold, reset variables for next iteration.
+    // The track has ended. If its length > m_adjacency_threshold keep it, then reset variables for next
+    // iteration.
     else {
+      if (track_length > m_adjacency_threshold)
+        m_adjacent_tracks.emplace_back(track_begin, track_begin + track_length);
       tol_count = 0;
-      win_adj.clear();
+      track_length = 0;
     }
   }
-
-  return win_adj_max;
 }
 
 // =====================================================================================
 // Functions below this line are for debugging purposes.
 // =====================================================================================
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerActivityMakerChannelAdjacency::add_window_to_record(TPWindow window)
 {
   m_window_record.push_back(window);
   return;
 }
+#endif
 
 // Register algo in TA Factory
 REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, TriggerActivityMakerChannelAdjacency)
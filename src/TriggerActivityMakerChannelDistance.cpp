@@ -11,6 +11,8 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerActivityMakerChannelDistancePlugin"
 
+#include <iterator>
+
 namespace triggeralgs {
 
 void
@@ -28,6 +30,12 @@ TriggerActivityMakerChannelDistance::operator()(const TriggerPrimitive& input_tp
                                                 std::vector<TriggerActivity>& output_tas)
 {
 
+  if (m_multi_cluster) {
+    close_expired_clusters(input_tp.time_start, output_tas);
+    add_to_clusters(input_tp);
+    return;
+  }
+
   // Start a new TA if not already going.
   if (m_current_ta.inputs.empty()) {
     set_new_ta(input_tp);
@@ -39,7 +47,7 @@ TriggerActivityMakerChannelDistance::operator()(const TriggerPrimitive& input_tp
     // Check to block the TA based on min TPs.
     if (m_current_ta.inputs.size() >= m_min_tps) {
       set_ta_attributes();
-      output_tas.push_back(m_current_ta);
+      output_tas.push_back(std::move(m_current_ta));
     }
     set_new_ta(input_tp);
     return;
@@ -54,6 +62,25 @@ TriggerActivityMakerChannelDistance::operator()(const TriggerPrimitive& input_tp
   m_current_upper_bound = std::max(m_current_upper_bound, input_tp.channel + m_max_channel_distance);
 }
 
+void
+TriggerActivityMakerChannelDistance::flush(timestamp_t until, std::vector<TriggerActivity>& output_tas)
+{
+  if (m_multi_cluster) {
+    close_expired_clusters(until, output_tas);
+    return;
+  }
+
+  // Same closing condition as operator(), which any TP at or after until would meet.
+  if (m_current_ta.inputs.empty() || until <= m_current_ta.inputs.front().time_start + m_window_length)
+    return;
+
+  if (m_current_ta.inputs.size() >= m_min_tps) {
+    set_ta_attributes();
+    output_tas.push_back(std::move(m_current_ta));
+  }
+  m_current_ta = TriggerActivity();
+}
+
 void
 TriggerActivityMakerChannelDistance::configure(const nlohmann::json& config)
 {
@@ -63,6 +90,8 @@ TriggerActivityMakerChannelDistance::configure(const nlohmann::json& config)
     m_window_length = config["window_length"];
   if (config.contains("max_channel_distance"))
     m_max_channel_distance = config["max_channel_distance"];
+  if (config.contains("multi_cluster"))
+    m_multi_cluster = config["multi_cluster"];
 
   return;
 }
@@ -70,30 +99,112 @@ TriggerActivityMakerChannelDistance::configure(const nlohmann::json& config)
 void
 TriggerActivityMakerChannelDistance::set_ta_attributes()
 {
-  TriggerPrimitive first_tp = m_current_ta.inputs.front();
-  TriggerPrimitive last_tp = m_current_ta.inputs.back();
+  set_ta_attributes(m_current_ta);
+}
 
-  m_current_ta.channel_start = first_tp.channel;
-  m_current_ta.channel_end = last_tp.channel;
+void
+TriggerActivityMakerChannelDistance::set_ta_attributes(TriggerActivity& ta) const
+{
+  const TriggerPrimitive& first_tp = ta.inputs.front();
+  const TriggerPrimitive& last_tp = ta.inputs.back();
 
-  m_current_ta.time_start = first_tp.time_start;
-  m_current_ta.time_end = last_tp.time_start;
+  ta.channel_start = first_tp.channel;
+  ta.channel_end = last_tp.channel;
 
-  m_current_ta.detid = first_tp.detid;
+  ta.time_start = first_tp.time_start;
+  ta.time_end = last_tp.time_start;
 
-  m_current_ta.algorithm = TriggerActivity::Algorithm::kChannelDistance;
-  m_current_ta.type = TriggerActivity::Type::kTPC;
+  ta.detid = first_tp.detid;
 
-  m_current_ta.adc_peak = 0;
-  for (const TriggerPrimitive& tp : m_current_ta.inputs) {
-    m_current_ta.adc_integral += tp.adc_integral;
-    if (tp.adc_peak <= m_current_ta.adc_peak)
+  ta.algorithm = TriggerActivity::Algorithm::kChannelDistance;
+  ta.type = TriggerActivity::Type::kTPC;
+
+  ta.adc_peak = 0;
+  for (const TriggerPrimitive& tp : ta.inputs) {
+    ta.adc_integral += tp.adc_integral;
+    if (tp.adc_peak <= ta.adc_peak)
       continue;
-    m_current_ta.adc_peak = tp.adc_peak;
-    m_current_ta.channel_peak = tp.channel;
-    m_current_ta.time_peak = tp.time_peak;
+    ta.adc_peak = tp.adc_peak;
+    ta.channel_peak = tp.channel;
+    ta.time_peak = tp.time_peak;
+  }
+  ta.time_activity = ta.time_peak;
+}
+
+void
+TriggerActivityMakerChannelDistance::close_expired_clusters(timestamp_t now, std::vector<TriggerActivity>& output_tas)
+{
+  // Same closing condition as the single TA mode, applied to every open cluster.
+  while (!m_cluster_expiry.empty() && now > m_cluster_expiry.begin()->first + m_window_length) {
+    auto cluster_it = m_clusters.find(m_cluster_expiry.begin()->second);
+    m_cluster_expiry.erase(m_cluster_expiry.begin());
+
+    TriggerActivity& ta = cluster_it->second.ta;
+    if (ta.inputs.size() >= m_min_tps) {
+      set_ta_attributes(ta);
+      // The inputs are time ordered, so take the channel range from the cluster instead.
+      ta.channel_start = cluster_it->first;
+      ta.channel_end = cluster_it->second.channel_end;
+      output_tas.push_back(std::move(ta));
+    }
+    m_clusters.erase(cluster_it);
+  }
+}
+
+void
+TriggerActivityMakerChannelDistance::add_to_clusters(const TriggerPrimitive& input_tp)
+{
+  // The TP belongs to every cluster with a TP within m_max_channel_distance of it. As the
+  // cluster channel ranges don't overlap, those clusters are consecutive in m_clusters.
+  channel_t lower = input_tp.channel > m_max_channel_distance ? input_tp.channel - m_max_channel_distance : 0;
+  channel_t upper = input_tp.channel + m_max_channel_distance;
+
+  auto first = m_clusters.upper_bound(lower);
+  if (first != m_clusters.begin() && std::prev(first)->second.channel_end >= lower)
+    --first;
+
+  // Not close to any open cluster: start a new one.
+  if (first == m_clusters.end() || first->first > upper) {
+    Cluster& cluster = m_clusters[input_tp.channel];
+    cluster.channel_end = input_tp.channel;
+    cluster.ta.inputs.push_back(input_tp);
+    m_cluster_expiry.emplace(input_tp.time_start, input_tp.channel);
+    return;
+  }
+
+  // Merge any further clusters the TP connects into the first one, keeping TPs time ordered.
+  Cluster& cluster = first->second;
+  timestamp_t time_start = cluster.ta.inputs.front().time_start;
+  m_cluster_expiry.erase({ time_start, first->first });
+
+  for (auto next = std::next(first); next != m_clusters.end() && next->first <= upper;) {
+    std::vector<TriggerPrimitive>& inputs = cluster.ta.inputs;
+    std::vector<TriggerPrimitive>& other_inputs = next->second.ta.inputs;
+    m_cluster_expiry.erase({ other_inputs.front().time_start, next->first });
+
+    size_t n_inputs = inputs.size();
+    inputs.insert(inputs.end(), std::make_move_iterator(other_inputs.begin()), std::make_move_iterator(other_inputs.end()));
+    std::inplace_merge(inputs.begin(),
+                       inputs.begin() + n_inputs,
+                       inputs.end(),
+                       [](const TriggerPrimitive& a, const TriggerPrimitive& b) { return a.time_start < b.time_start; });
+    cluster.channel_end = next->second.channel_end;
+    next = m_clusters.erase(next);
+  }
+
+  cluster.channel_end = std::max(cluster.channel_end, input_tp.channel);
+  cluster.ta.inputs.push_back(input_tp);
+  time_start = cluster.ta.inputs.front().time_start;
+
+  // Re-key the cluster if the TP extends it to lower channels.
+  channel_t key = first->first;
+  if (input_tp.channel < key) {
+    auto node = m_clusters.extract(first);
+    node.key() = input_tp.channel;
+    key = input_tp.channel;
+    m_clusters.insert(std::move(node));
   }
-  m_current_ta.time_activity = m_current_ta.time_peak;
+  m_cluster_expiry.emplace(time_start, key);
 }
 
 // Register algo in TA Factory
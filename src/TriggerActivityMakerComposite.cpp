@@ -0,0 +1,301 @@
+/**
+ * @file TriggerActivityMakerComposite.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/Composite/TriggerActivityMakerComposite.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "TriggerActivityMakerCompositePlugin"
+
+#include <algorithm>
+
+namespace triggeralgs {
+
+using Logging::TLVL_DEBUG_ALL;
+using Logging::TLVL_DEBUG_MEDIUM;
+using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
+
+void
+SharedTPWindow::add(const TriggerPrimitive& input_tp)
+{
+  adc_integral += input_tp.adc_integral;
+  channel_counts[input_tp.channel]++;
+  m_tps.push_back(input_tp);
+}
+
+void
+SharedTPWindow::clear()
+{
+  m_tps.clear();
+  m_first = 0;
+  channel_counts.clear();
+  adc_integral = 0;
+}
+
+void
+SharedTPWindow::reset(const TriggerPrimitive& input_tp)
+{
+  clear();
+  add(input_tp);
+}
+
+void
+SharedTPWindow::move(const TriggerPrimitive& input_tp, timestamp_t window_length)
+{
+  while (m_first < m_tps.size() && !(input_tp.time_start - m_tps[m_first].time_start < window_length)) {
+    const TriggerPrimitive& tp = m_tps[m_first++];
+    adc_integral -= tp.adc_integral;
+    auto channel = channel_counts.find(tp.channel);
+    if (--channel->second == 0)
+      channel_counts.erase(channel);
+  }
+
+  if (is_empty()) {
+    reset(input_tp);
+    return;
+  }
+  // Only copy the live TPs down once the dead ones outnumber them.
+  if (m_first > m_tps.size() / 2) {
+    m_tps.erase(m_tps.begin(), m_tps.begin() + m_first);
+    m_first = 0;
+  }
+  add(input_tp);
+}
+
+namespace {
+
+// Total ADC in the window, as in ADCSimpleWindow.
+class AdcCondition : public CompositeCondition
+{
+public:
+  bool operator()(const SharedTPWindow& window) const override { return window.adc_integral > m_threshold; }
+  void configure(const nlohmann::json& config) override
+  {
+    if (config.contains("threshold"))
+      m_threshold = config["threshold"];
+  }
+  TriggerActivity::Algorithm algorithm() const override { return TriggerActivity::Algorithm::kADCSimpleWindow; }
+
+private:
+  uint64_t m_threshold = 3000000;
+};
+
+// Number of distinct channels hit in the window.
+class ChannelCountCondition : public CompositeCondition
+{
+public:
+  bool operator()(const SharedTPWindow& window) const override { return window.n_channels_hit() > m_threshold; }
+  void configure(const nlohmann::json& config) override
+  {
+    if (config.contains("threshold"))
+      m_threshold = config["threshold"];
+  }
+  TriggerActivity::Algorithm algorithm() const override { return TriggerActivity::Algorithm::kHorizontalMuon; }
+
+private:
+  uint16_t m_threshold = 400;
+};
+
+// Longest run of adjacent hit channels, counted as in HorizontalMuon: gaps of up to 4 missing
+// channels are bridged while the running gap tally is below tolerance.
+class AdjacencyCondition : public CompositeCondition
+{
+public:
+  bool operator()(const SharedTPWindow& window) const override
+  {
+    if (window.channel_counts.empty())
+      return false;
+
+    uint16_t adj = 1;
+    uint16_t tol_count = 0;
+    auto it = window.channel_counts.begin();
+    channel_t previous = it->first;
+    for (++it; it != window.channel_counts.end(); previous = (it++)->first) {
+      auto gap = it->first - previous;
+      if (gap == 1) {
+        ++adj;
+      } else if (gap <= 5 && tol_count < m_tolerance) {
+        ++adj;
+        tol_count += gap;
+      } else {
+        adj = 1;
+        tol_count = 0;
+      }
+      // Only whether the threshold is passed matters, so stop at the first run that does.
+      if (adj > m_threshold)
+        return true;
+    }
+    return false;
+  }
+  void configure(const nlohmann::json& config) override
+  {
+    if (config.contains("threshold"))
+      m_threshold = config["threshold"];
+    if (config.contains("tolerance"))
+      m_tolerance = config["tolerance"];
+  }
+  TriggerActivity::Algorithm algorithm() const override { return TriggerActivity::Algorithm::kHorizontalMuon; }
+
+private:
+  uint16_t m_threshold = 15;
+  uint16_t m_tolerance = 3;
+};
+
+template<class C>
+struct ConditionRegistrar
+{
+  explicit ConditionRegistrar(const std::string& type)
+  {
+    TriggerActivityMakerComposite::register_condition(type, []() { return std::make_unique<C>(); });
+  }
+};
+
+const ConditionRegistrar<AdcCondition> adc_registrar("adc");
+const ConditionRegistrar<ChannelCountCondition> n_channels_registrar("n_channels");
+const ConditionRegistrar<AdjacencyCondition> adjacency_registrar("adjacency");
+
+} // namespace
+
+std::map<std::string, TriggerActivityMakerComposite::ConditionCreator>&
+TriggerActivityMakerComposite::condition_registry()
+{
+  static std::map<std::string, ConditionCreator> registry;
+  return registry;
+}
+
+void
+TriggerActivityMakerComposite::register_condition(const std::string& type, ConditionCreator creator)
+{
+  condition_registry()[type] = std::move(creator);
+}
+
+void
+TriggerActivityMakerComposite::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+{
+  if (m_current_window.is_empty()) {
+    m_current_window.reset(input_tp);
+    return;
+  }
+
+  if (input_tp.time_start - m_current_window.time_start() < m_window_length) {
+    m_current_window.add(input_tp);
+    return;
+  }
+
+  // The window is complete: either it triggers and restarts with this TP, or it slides along.
+  if (const CompositeCondition* fired = check_conditions()) {
+    if (++m_n_triggered % m_prescale == 0) {
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:CO] Emitting TA with " << m_current_window.size() << " TPs on "
+                                                << m_current_window.n_channels_hit() << " channels and ADC integral "
+                                                << m_current_window.adc_integral << ".";
+      output_ta.push_back(construct_ta(*fired));
+    }
+    m_current_window.reset(input_tp);
+  } else {
+    m_current_window.move(input_tp, m_window_length);
+  }
+
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:CO] Window starts at " << m_current_window.time_start() << " with "
+                                         << m_current_window.size() << " TPs.";
+}
+
+void
+TriggerActivityMakerComposite::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // Any TP at or after until would close the window. If it would trigger, do so now and leave
+  // the window empty for that TP to start a new one. Otherwise the TP decides what is evicted.
+  if (m_current_window.is_empty() || until < m_current_window.time_start() + m_window_length)
+    return;
+
+  const CompositeCondition* fired = check_conditions();
+  if (!fired)
+    return;
+
+  if (++m_n_triggered % m_prescale == 0) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:CO] Emitting TA from flushed window with " << m_current_window.size()
+                                              << " TPs.";
+    output_ta.push_back(construct_ta(*fired));
+  }
+  m_current_window.clear();
+}
+
+void
+TriggerActivityMakerComposite::configure(const nlohmann::json& config)
+{
+  m_conditions.clear();
+  if (config.is_object()) {
+    if (config.contains("window_length"))
+      m_window_length = config["window_length"];
+    if (config.contains("prescale"))
+      m_prescale = std::max<uint64_t>(config["prescale"].get<uint64_t>(), 1);
+    if (config.contains("conditions")) {
+      for (const auto& condition_config : config["conditions"]) {
+        std::string type = condition_config.value("type", "");
+        auto creator = condition_registry().find(type);
+        if (creator == condition_registry().end()) {
+          TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:CO] Unknown condition type '" << type << "', skipping it.";
+          continue;
+        }
+        m_conditions.push_back(creator->second());
+        m_conditions.back()->configure(condition_config);
+      }
+    }
+  }
+
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:CO] Checking " << m_conditions.size() << " conditions on a "
+                                         << m_window_length << " tick window.";
+}
+
+const CompositeCondition*
+TriggerActivityMakerComposite::check_conditions() const
+{
+  for (const auto& condition : m_conditions) {
+    if ((*condition)(m_current_window))
+      return condition.get();
+  }
+  return nullptr;
+}
+
+TriggerActivity
+TriggerActivityMakerComposite::construct_ta(const CompositeCondition& fired) const
+{
+  const TriggerPrimitive& last_tp = m_current_window.back();
+
+  TriggerActivity ta;
+  ta.time_start = last_tp.time_start;
+  ta.time_end = last_tp.time_start + last_tp.time_over_threshold;
+  ta.time_peak = last_tp.time_peak;
+  ta.time_activity = last_tp.time_peak;
+  ta.channel_start = last_tp.channel;
+  ta.channel_end = last_tp.channel;
+  ta.channel_peak = last_tp.channel;
+  ta.adc_integral = m_current_window.adc_integral;
+  ta.adc_peak = last_tp.adc_peak;
+  ta.detid = last_tp.detid;
+  ta.type = TriggerActivity::Type::kTPC;
+  ta.algorithm = fired.algorithm();
+  ta.inputs.assign(m_current_window.begin(), m_current_window.end());
+
+  for (const auto& tp : ta.inputs) {
+    ta.time_start = std::min(ta.time_start, tp.time_start);
+    ta.time_end = std::max(ta.time_end, tp.time_start + tp.time_over_threshold);
+    ta.channel_start = std::min(ta.channel_start, tp.channel);
+    ta.channel_end = std::max(ta.channel_end, tp.channel);
+    if (tp.adc_peak > ta.adc_peak) {
+      ta.time_peak = tp.time_peak;
+      ta.adc_peak = tp.adc_peak;
+      ta.channel_peak = tp.channel;
+    }
+  }
+
+  return ta;
+}
+
+REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, TriggerActivityMakerComposite)
+
+} // namespace triggeralgs
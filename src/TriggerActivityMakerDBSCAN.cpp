@@ -24,16 +24,46 @@ using Logging::TLVL_DEBUG_LOW;
 void
 TriggerActivityMakerDBSCAN::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
 {
+  MakerMetrics::Scope scope(m_metrics);
   if(input_tp.time_start < m_prev_timestamp){
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:DBS] Out-of-order TPs: prev " << m_prev_timestamp << ", current " << input_tp.time_start;
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:DBS] Out-of-order TPs: prev " << m_prev_timestamp << ", current " << input_tp.time_start;
+    m_metrics.count_drops();
     return;
   }
-  
+  m_metrics.record_arrival(input_tp.time_start);
+
   m_dbscan_clusters.clear();
   m_dbscan->add_primitive(input_tp, &m_dbscan_clusters);
+  make_tas(output_ta);
+  m_metrics.count_outputs(m_dbscan_clusters.size());
+  record_latency(input_tp.time_start, output_ta);
+
+  m_dbscan->trim_hits();
+  m_metrics.set_occupancy(m_dbscan->get_n_hits());
+}
+
+void
+TriggerActivityMakerDBSCAN::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // Clusters that no TP at or after until can reach are complete already.
+  m_dbscan_clusters.clear();
+  m_dbscan->flush(until, &m_dbscan_clusters);
+  make_tas(output_ta);
+  m_metrics.count_outputs(m_dbscan_clusters.size());
+  record_latency(until, output_ta);
+}
 
-  uint64_t t0=m_dbscan->get_first_prim_time();
-  
+void
+TriggerActivityMakerDBSCAN::record_latency(timestamp_t now, const std::vector<TriggerActivity>& output_ta)
+{
+  // make_tas() appended one TA per cluster.
+  for (size_t i = output_ta.size() - m_dbscan_clusters.size(); i < output_ta.size(); ++i)
+    m_metrics.record_latency(now, output_ta[i].inputs);
+}
+
+void
+TriggerActivityMakerDBSCAN::make_tas(std::vector<TriggerActivity>& output_ta) const
+{
   for(auto const& cluster : m_dbscan_clusters){
     auto& ta=output_ta.emplace_back();
 
@@ -68,8 +98,6 @@ TriggerActivityMakerDBSCAN::operator()(const TriggerPrimitive& input_tp, std::ve
     ta.type = TriggerActivity::Type::kTPC;
     ta.algorithm = TriggerActivity::Algorithm::kDBSCAN;
   }
-
-  m_dbscan->trim_hits();
 }
 
 void
@@ -10,6 +10,7 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerActivityMakerHorizontalMuonPlugin"
 #include <math.h>
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -21,22 +22,33 @@ void
 TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
                                                std::vector<TriggerActivity>& output_ta)
 {
+  VectorSink<TriggerActivity> sink(output_ta);
+  (*this)(input_tp, sink);
+}
+
+void
+TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
+                                               OutputSink<TriggerActivity>& output_ta)
+{
+  MakerMetrics::Scope scope(m_metrics);
+  m_metrics.record_arrival(input_tp.time_start);
 
   uint16_t adjacency;
 
   // Add useful info about recived TPs here for FW and SW TPG guys.
   if (m_print_tp_info) {
-    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:HM] TP Start Time: " << input_tp.time_start
-                               << ", TP ADC Sum: " << input_tp.adc_integral
-                               << ", TP TOT: " << input_tp.time_over_threshold << ", TP ADC Peak: " << input_tp.adc_peak
-                               << ", TP Offline Channel ID: " << input_tp.channel;
-    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:HM] Adjacency of current window is: " << check_adjacency();
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:HM] TP Start Time: " << input_tp.time_start
+                                           << ", TP ADC Sum: " << input_tp.adc_integral
+                                           << ", TP TOT: " << input_tp.time_over_threshold << ", TP ADC Peak: " << input_tp.adc_peak
+                                           << ", TP Offline Channel ID: " << input_tp.channel;
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:HM] Adjacency of current window is: " << check_adjacency();
   }
 
   // 0) FIRST TP =====================================================================
   // The first time operator() is called, reset the window object.
   if (m_current_window.is_empty()) {
     m_current_window.reset(input_tp);
+    m_metrics.set_occupancy(m_current_window.inputs.size());
     return;
   }
 
@@ -53,14 +65,19 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
   // make a TA and start a fresh window with the current TP.
   else if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
 
+    m_metrics.count_trigger(0);
     ta_count++;
     if (ta_count % m_prescale == 0) {
+      m_metrics.record_latency(input_tp.time_start, m_current_window.inputs);
       auto ta = construct_ta();
-      TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM]: Emitting ADC threshold trigger with " << m_current_window.adc_integral
-                                    << " window ADC integral. ta.time_start=" << ta.time_start
-                                    << " ta.time_end=" << ta.time_end;
-      output_ta.push_back(ta);
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM]: Emitting ADC threshold trigger with " << m_current_window.adc_integral
+                                                << " window ADC integral. ta.time_start=" << ta.time_start
+                                                << " ta.time_end=" << ta.time_end;
+      output_ta.emit(std::move(ta));
+      m_metrics.count_outputs();
       m_current_window.reset(input_tp);
+    } else {
+      m_metrics.count_drops();
     }
   }
 
@@ -71,14 +88,19 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
   // on channel multiplicity, make a TA and start a fresh window with the current TP.
   else if (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels) {
 
+    m_metrics.count_trigger(1);
     ta_count++;
     if (ta_count % m_prescale == 0) {
 
-      TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting multiplicity trigger with "
-                                    << m_current_window.n_channels_hit() << " unique channels hit.";
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting multiplicity trigger with "
+                                                << m_current_window.n_channels_hit() << " unique channels hit.";
 
-      output_ta.push_back(construct_ta());
+      m_metrics.record_latency(input_tp.time_start, m_current_window.inputs);
+      output_ta.emit(construct_ta());
+      m_metrics.count_outputs();
       m_current_window.reset(input_tp);
+    } else {
+      m_metrics.count_drops();
     }
   }
 
@@ -89,6 +111,7 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
   // on adjacency, then create a TA and reset the window with the new/current TP.
   else if ((adjacency = check_adjacency()) > m_adjacency_threshold && m_trigger_on_adjacency) {
 
+    m_metrics.count_trigger(2);
     ta_count++;
     if (ta_count % m_prescale == 0) {
 
@@ -99,13 +122,17 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
       if (adjacency > m_max_adjacency) {
         m_max_adjacency = adjacency;
       }
-      TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting track and multiplicity TA with adjacency "
-                                    << check_adjacency() << " and multiplicity " << m_current_window.n_channels_hit()
-                                    << ". The ADC integral of this TA is " << m_current_window.adc_integral
-                                    << " and the largest longest track seen so far is " << m_max_adjacency;
-
-      output_ta.push_back(construct_ta());
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting track and multiplicity TA with adjacency "
+                                                << check_adjacency() << " and multiplicity " << m_current_window.n_channels_hit()
+                                                << ". The ADC integral of this TA is " << m_current_window.adc_integral
+                                                << " and the largest longest track seen so far is " << m_max_adjacency;
+
+      m_metrics.record_latency(input_tp.time_start, m_current_window.inputs);
+      output_ta.emit(construct_ta());
+      m_metrics.count_outputs();
       m_current_window.reset(input_tp);
+    } else {
+      m_metrics.count_drops();
     }
   }
 
@@ -114,10 +141,13 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
 
     // If the incoming TP has a large time over threshold, we might have a cluster of
     // interesting physics activity surrounding it. Trigger on that.
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting a TA due to a TP with a very large time over threshold: "
-                                  << input_tp.time_over_threshold << " ticks and offline channel: " << input_tp.channel
-                                  << ", where the ADC integral of that TP is " << input_tp.adc_integral;
-    output_ta.push_back(construct_ta());
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting a TA due to a TP with a very large time over threshold: "
+                                              << input_tp.time_over_threshold << " ticks and offline channel: " << input_tp.channel
+                                              << ", where the ADC integral of that TP is " << input_tp.adc_integral;
+    m_metrics.count_trigger(3);
+    m_metrics.record_latency(input_tp.time_start, m_current_window.inputs);
+    output_ta.emit(construct_ta());
+    m_metrics.count_outputs();
     m_current_window.reset(input_tp);
   }
 
@@ -126,9 +156,50 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
     m_current_window.move(input_tp, m_window_length);
   }
 
+  m_metrics.set_occupancy(m_current_window.inputs.size());
   return;
 }
 
+void
+TriggerActivityMakerHorizontalMuon::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  VectorSink<TriggerActivity> sink(output_ta);
+  flush(until, sink);
+}
+
+void
+TriggerActivityMakerHorizontalMuon::flush(timestamp_t until, OutputSink<TriggerActivity>& output_ta)
+{
+  // Any TP at or after until would close the window and check conditions 1) to 3) on it.
+  // The large TOT check, and what happens when the prescale skips a TA, depend on that TP,
+  // so those cases are left for it.
+  if (m_current_window.is_empty() || until < m_current_window.time_start + m_window_length)
+    return;
+
+  // The condition counted is the first one met, in the same order as operator() checks them.
+  size_t condition;
+  if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc)
+    condition = 0;
+  else if (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels)
+    condition = 1;
+  else if (m_trigger_on_adjacency && check_adjacency() > m_adjacency_threshold)
+    condition = 2;
+  else
+    return;
+  if (static_cast<uint16_t>(ta_count + 1) % m_prescale != 0)
+    return;
+
+  m_metrics.count_trigger(condition);
+  ta_count++;
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting TA from flushed window with " << m_current_window.adc_integral
+                                            << " window ADC integral.";
+  m_metrics.record_latency(until, m_current_window.inputs);
+  output_ta.emit(construct_ta());
+  m_metrics.count_outputs();
+  m_current_window.clear();
+  m_metrics.set_occupancy(0);
+}
+
 void
 TriggerActivityMakerHorizontalMuon::configure(const nlohmann::json& config)
 {
@@ -213,8 +284,10 @@ TriggerActivityMakerHorizontalMuon::check_adjacency() const
   unsigned int next = 0;         // The next position in the hit channels vector
   unsigned int tol_count = 0;    // Tolerance count, should not pass adj_tolerance
 
-  // Generate a channelID ordered list of hit channels for this window
-  std::vector<int> chanList;
+  // Generate a channelID ordered list of hit channels for this window, in the maker's own
+  // list so that its storage is reused from one call to the next.
+  std::vector<int>& chanList = m_channel_list;
+  chanList.clear();
   for (auto tp : m_current_window.inputs) {
     chanList.push_back(tp.channel);
   }
@@ -275,6 +348,7 @@ TriggerActivityMakerHorizontalMuon::check_adjacency() const
 // =====================================================================================
 // Functions below this line are for debugging purposes.
 // =====================================================================================
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerActivityMakerHorizontalMuon::add_window_to_record(TPWindow window)
 {
@@ -328,6 +402,7 @@ TriggerActivityMakerHorizontalMuon::dump_tp(TriggerPrimitive const& input_tp)
 
   return;
 }
+#endif
 
 int
 TriggerActivityMakerHorizontalMuon::check_tot() const
@@ -45,7 +45,7 @@ TriggerActivityMakerMichelElectron::operator()(const TriggerPrimitive& input_tp,
      
      if (check_bragg_peak(trackHits)){
        if (check_kinks(trackHits)){
-         TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:ME] Emitting a trigger for candidate Michel event.";
+         TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:ME] Emitting a trigger for candidate Michel event.";
          output_ta.push_back(construct_ta());
          m_current_window.reset(input_tp);
        } // Kinks 
@@ -308,6 +308,7 @@ TriggerActivityMakerMichelElectron::check_kinks(std::vector<TriggerPrimitive> fi
 // Functions below this line are for debugging purposes.
 // ===============================================================================================
 
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerActivityMakerMichelElectron::add_window_to_record(Window window)
 {
@@ -363,29 +364,23 @@ TriggerActivityMakerMichelElectron::dump_tp(TriggerPrimitive const& input_tp)
 
   return;
 }
+#endif
 
-/*
 void
-TriggerActivityMakerMichelElectron::flush(timestamp_t, std::vector<TriggerActivity>& output_ta)
+TriggerActivityMakerMichelElectron::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
 {
-  // Check the status of the current window, construct TA if conditions are met. Regardless
-  // of whether the conditions are met, reset the window.
-  if(m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc){
-  //else if(m_current_window.adc_integral > m_conf.adc_threshold && m_conf.trigger_on_adc){
-    //TLOG_DEBUG(TRACE_NAME) << "ADC integral in window is greater than specified threshold.";
-    output_ta.push_back(construct_ta());
-  }
-  else if(m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels){
-  //else if(m_current_window.n_channels_hit() > m_conf.n_channels_threshold && m_conf.trigger_on_n_channels){
-    //TLOG_DEBUG(TRACE_NAME) << "Number of channels hit in the window is greater than specified threshold.";
+  // Any TP at or after until would close the window and run the Michel checks on it. A
+  // window that passes them is emitted now; one that doesn't is left for that TP to slide.
+  if (m_current_window.is_empty() || until < m_current_window.time_start + m_window_length)
+    return;
+
+  std::vector<TriggerPrimitive> trackHits = longest_activity();
+  if (trackHits.size() > m_adjacency_threshold && check_bragg_peak(trackHits) && check_kinks(trackHits)) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:ME] Emitting a trigger for candidate Michel event from flushed window.";
     output_ta.push_back(construct_ta());
+    m_current_window.clear();
   }
-
-  //TLOG_DEBUG(TRACE_NAME) << "Clearing the current window, on the arrival of the next input_tp, the window will be
-reset."; m_current_window.clear();
-
-  return;
-}*/
+}
 
 // Register algo in TA Factory
 REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, TriggerActivityMakerMichelElectron)
@@ -62,21 +62,9 @@ TriggerActivityMakerPlaneCoincidence::operator()(const TriggerPrimitive& input_t
   else if (collectionComplete && (m_induction1_window.adc_integral + m_induction2_window.adc_integral + m_collection_window.adc_integral)
             > m_adc_threshold && check_adjacency(m_collection_window) >= m_adjacency_threshold){
 
-          TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:PC] Emitting low energy trigger with " << m_induction1_window.adc_integral << " U "
-                  << m_induction2_window.adc_integral << " Y induction ADC sums and "
-                  << check_adjacency(m_collection_window) << " adjacent collection hits.";
-   
-          // Initial studies - output the TPs of the collection plane window that caused this trigger
-          add_window_to_record(m_collection_window);
-          dump_window_record();
-          m_window_record.clear();     
-
-          // Initial studies - Also dump the TPs that have contributed to this TA decision
-          for(auto tp : m_collection_window.inputs) dump_tp(tp);
- 
           // We have fulfilled our trigger condition, construct a TA and reset/flush the windows
           // to ensure they're all in the same "time zone"!
-          output_ta.push_back(construct_ta(m_collection_window));
+          emit_ta(output_ta);
           if (isZ) m_collection_window.reset(input_tp);
           else m_collection_window.clear();
           if (isU) m_induction1_window.reset(input_tp); 
@@ -96,6 +84,43 @@ TriggerActivityMakerPlaneCoincidence::operator()(const TriggerPrimitive& input_t
   return;
 }
 
+void
+TriggerActivityMakerPlaneCoincidence::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // Any TP after until would find the collection window complete and make this same check,
+  // with induction ADC sums at least as large, so a window passing it now would pass then.
+  if (m_collection_window.is_empty() || until <= m_collection_window.time_start + m_window_length)
+    return;
+
+  if ((m_induction1_window.adc_integral + m_induction2_window.adc_integral + m_collection_window.adc_integral)
+        > m_adc_threshold && check_adjacency(m_collection_window) >= m_adjacency_threshold) {
+    emit_ta(output_ta);
+    m_collection_window.clear();
+    m_induction1_window.clear();
+    m_induction2_window.clear();
+  }
+}
+
+void
+TriggerActivityMakerPlaneCoincidence::emit_ta(std::vector<TriggerActivity>& output_ta)
+{
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:PC] Emitting low energy trigger with " << m_induction1_window.adc_integral << " U "
+                                            << m_induction2_window.adc_integral << " Y induction ADC sums and "
+                                            << check_adjacency(m_collection_window) << " adjacent collection hits.";
+
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
+  // Initial studies - output the TPs of the collection plane window that caused this trigger
+  add_window_to_record(m_collection_window);
+  dump_window_record();
+  m_window_record.clear();
+
+  // Initial studies - Also dump the TPs that have contributed to this TA decision
+  for(auto tp : m_collection_window.inputs) dump_tp(tp);
+#endif
+
+  output_ta.push_back(construct_ta(m_collection_window));
+}
+
 void
 TriggerActivityMakerPlaneCoincidence::configure(const nlohmann::json& config)
 {
@@ -206,6 +231,7 @@ TriggerActivityMakerPlaneCoincidence::check_adjacency(TPWindow window) const
 // =====================================================================================
 // Functions below this line are for debugging and performance study purposes.
 // =====================================================================================
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerActivityMakerPlaneCoincidence::add_window_to_record(TPWindow window)
 {
@@ -261,6 +287,7 @@ TriggerActivityMakerPlaneCoincidence::dump_tp(TriggerPrimitive const& input_tp)
 
   return;
 }
+#endif
 
 int
 TriggerActivityMakerPlaneCoincidence::check_tot(TPWindow m_current_window) const
@@ -11,6 +11,7 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerActivityMakerPrescalePlugin"
 
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -21,12 +22,17 @@ using Logging::TLVL_IMPORTANT;
 void
 TriggerActivityMakerPrescale::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
 {
-  if ((m_primitive_count++) % m_prescale == 0) {
+  VectorSink<TriggerActivity> sink(output_ta);
+  (*this)(input_tp, sink);
+}
 
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:Pr] Emitting prescaled TriggerActivity " << (m_primitive_count - 1);
-    std::vector<TriggerPrimitive> tp_list;
-    tp_list.push_back(input_tp);
+void
+TriggerActivityMakerPrescale::operator()(const TriggerPrimitive& input_tp, OutputSink<TriggerActivity>& output_ta)
+{
+  MakerMetrics::Scope scope(m_metrics);
+  if ((m_primitive_count++) % m_prescale == 0) {
 
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:Pr] Emitting prescaled TriggerActivity " << (m_primitive_count - 1);
     TriggerActivity ta;
     ta.time_start = input_tp.time_start;
     ta.time_end = input_tp.time_start + input_tp.time_over_threshold;
@@ -41,9 +47,12 @@ TriggerActivityMakerPrescale::operator()(const TriggerPrimitive& input_tp, std::
     ta.type = TriggerActivity::Type::kTPC;
     ta.algorithm = TriggerActivity::Algorithm::kPrescale;
 
-    ta.inputs = tp_list;
+    ta.inputs.push_back(input_tp);
 
-    output_ta.push_back(ta);
+    output_ta.emit(std::move(ta));
+    m_metrics.count_outputs();
+  } else {
+    m_metrics.count_drops();
   }
 }
 
@@ -54,7 +63,7 @@ TriggerActivityMakerPrescale::configure(const nlohmann::json& config)
   if (config.is_object() && config.contains("prescale")) {
     m_prescale = config["prescale"];
   }
-  TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:Pr] Using activity prescale " << m_prescale;
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:Pr] Using activity prescale " << m_prescale;
 }
 
 // Register algo in TA Factory
@@ -11,22 +11,58 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerCandidateMakerADCSimpleWindowPlugin"
 
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
 
 using Logging::TLVL_DEBUG_LOW;
+using Logging::TLVL_IMPORTANT;
 
 void
 TriggerCandidateMakerADCSimpleWindow::operator()(const TriggerActivity& activity, std::vector<TriggerCandidate>& cand)
+{
+  VectorSink<TriggerCandidate> sink(cand);
+  make_candidate(activity, sink);
+}
+
+void
+TriggerCandidateMakerADCSimpleWindow::operator()(const TriggerActivity& activity, OutputSink<TriggerCandidate>& cand)
+{
+  make_candidate(activity, cand);
+}
+
+void
+TriggerCandidateMakerADCSimpleWindow::operator()(TriggerActivity&& activity, OutputSink<TriggerCandidate>& cand)
+{
+  make_candidate(activity, cand);
+}
+
+void
+TriggerCandidateMakerADCSimpleWindow::operator()(const ActivityView& activity, std::vector<TriggerCandidate>& cand)
+{
+  if (!activity.is_valid()) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TCM:ADCSW] Skipping a TriggerActivity overlay that overruns its buffer";
+    m_metrics.count_drops();
+    return;
+  }
+  VectorSink<TriggerCandidate> sink(cand);
+  make_candidate(activity.data(), sink);
+}
+
+void
+TriggerCandidateMakerADCSimpleWindow::make_candidate(const TriggerActivity::TriggerActivityData& activity,
+                                                     OutputSink<TriggerCandidate>& cand)
 { 
+  MakerMetrics::Scope scope(m_metrics);
+  m_metrics.record_arrival(activity.time_start, 1);
 
   // For now, if there is any single activity from any one detector element, emit
   // a trigger candidate.
   m_activity_count++;
-  std::vector<TriggerActivity::TriggerActivityData> ta_list = {static_cast<TriggerActivity::TriggerActivityData>(activity)};
+  std::vector<TriggerActivity::TriggerActivityData> ta_list = {activity};
 
-  TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ADCSW] Emitting an ADCSimpleWindow TriggerCandidate " << (m_activity_count-1);
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ADCSW] Emitting an ADCSimpleWindow TriggerCandidate " << (m_activity_count-1);
   TriggerCandidate tc;
   tc.time_start = activity.time_start; 
   tc.time_end = activity.time_end;  
@@ -36,8 +72,10 @@ TriggerCandidateMakerADCSimpleWindow::operator()(const TriggerActivity& activity
   tc.algorithm = TriggerCandidate::Algorithm::kADCSimpleWindow;
 
   tc.inputs = ta_list;
+  m_metrics.record_latency(activity.time_start, tc.inputs);
 
-  cand.push_back(tc);
+  cand.emit(std::move(tc));
+  m_metrics.count_outputs();
 
 }
 
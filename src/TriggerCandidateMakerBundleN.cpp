@@ -40,7 +40,7 @@ TriggerCandidateMakerBundleN::operator()(const TriggerActivity& input_ta, std::v
   m_current_tc.inputs.push_back(input_ta);
 
   if (bundle_condition()) {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TC:BN] Emitting BundleN TriggerCandidate with " << m_current_tc.inputs.size() << " TAs.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TC:BN] Emitting BundleN TriggerCandidate with " << m_current_tc.inputs.size() << " TAs.";
     set_tc_attributes();
     output_tcs.push_back(m_current_tc);
 
@@ -50,7 +50,7 @@ TriggerCandidateMakerBundleN::operator()(const TriggerActivity& input_ta, std::v
 
   // Should never reach this step. In this case, send it out.
   if (m_current_tc.inputs.size() > m_bundle_size) {
-    TLOG_DEBUG(TLVL_IMPORTANT) << "[TC:BN] Emitting large BundleN TriggerCandidate with " << m_current_tc.inputs.size() << " TAs.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TC:BN] Emitting large BundleN TriggerCandidate with " << m_current_tc.inputs.size() << " TAs.";
     set_tc_attributes();
     output_tcs.push_back(m_current_tc);
 
@@ -13,6 +13,7 @@
 #define TRACE_NAME "TriggerCandidateMakerChannelAdjacencyPlugin"
 
 #include <math.h>
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -26,24 +27,36 @@ void
 TriggerCandidateMakerChannelAdjacency::operator()(const TriggerActivity& activity,
                                                   std::vector<TriggerCandidate>& output_tc)
 {
+  // Every path below keeps the TA in the window, so copy it once here.
+  (*this)(TriggerActivity(activity), output_tc);
+}
+
+void
+TriggerCandidateMakerChannelAdjacency::operator()(TriggerActivity&& activity, std::vector<TriggerCandidate>& output_tc)
+{
+  MakerMetrics::Scope scope(m_metrics, output_tc);
+  ActivityRef ref = m_reference_inputs ? m_activity_store.add(activity) : ActivityRef();
+  // The TA itself is moved into the window below.
+  const timestamp_t now = activity.time_start;
+  m_metrics.record_arrival(now, 1);
 
   // The first time operator is called, reset window object.
   if (m_current_window.is_empty()) {
-    m_current_window.reset(activity);
+    m_current_window.reset(std::move(activity), ref);
     m_activity_count++;
   }
 
   // If the difference between the current TA's start time and the start of the window
   // is less than the specified window size, add the TA to the window.
   else if ((activity.time_start - m_current_window.time_start) < m_window_length) {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:CA] Window not yet complete, adding the activity to the window.";
-    m_current_window.add(activity);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:CA] Window not yet complete, adding the activity to the window.";
+    m_current_window.add(std::move(activity), ref);
   }
   // If it is not, move the window along.
   else {
-    TLOG_DEBUG(TLVL_DEBUG_ALL)
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL)
       << "[TCM:CA] TAWindow is at required length but specified threshold not met, shifting window along.";
-    m_current_window.move(activity, m_window_length);
+    m_current_window.move(std::move(activity), m_window_length, ref);
   }
 
   // If the addition of the current TA to the window would make it longer
@@ -51,16 +64,18 @@ TriggerCandidateMakerChannelAdjacency::operator()(const TriggerActivity& activit
   // the existing window is above the specified threshold. If it is, and we are triggering on ADC,
   // make a TA and start a fresh window with the current TP.
   if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:CA] m_current_window.adc_integral " << m_current_window.adc_integral
-                                  << " - m_adc_threshold " << m_adc_threshold;
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:CA] m_current_window.adc_integral " << m_current_window.adc_integral
+                                              << " - m_adc_threshold " << m_adc_threshold;
+    m_metrics.count_trigger(0);
     m_tc_number++;
+    m_metrics.record_latency(now, m_current_window.inputs);
     TriggerCandidate tc = construct_tc();
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:CA] tc.time_start=" << tc.time_start << " tc.time_end=" << tc.time_end
-                                  << " len(tc.inputs) " << tc.inputs.size();
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:CA] tc.time_start=" << tc.time_start << " tc.time_end=" << tc.time_end
+                                              << " len(tc.inputs) " << tc.inputs.size();
 
     for (const auto& ta : tc.inputs) {
-      TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TCM:CA] [TA] ta.time_start=" << ta.time_start << " ta.time_end=" << ta.time_end
-                                 << " ta.adc_integral=" << ta.adc_integral;
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TCM:CA] [TA] ta.time_start=" << ta.time_start << " ta.time_end=" << ta.time_end
+                                             << " ta.adc_integral=" << ta.adc_integral;
     }
 
     output_tc.push_back(tc);
@@ -72,12 +87,15 @@ TriggerCandidateMakerChannelAdjacency::operator()(const TriggerActivity& activit
   // the existing window is above the specified threshold. If it is, and we are triggering on channels,
   // make a TC and start a fresh window with the current TA.
   else if (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels) {
+    m_metrics.count_trigger(1);
     m_tc_number++;
 
+    m_metrics.record_latency(now, m_current_window.inputs);
     output_tc.push_back(construct_tc());
     m_current_window.clear();
   }
 
+  m_metrics.set_occupancy(m_current_window.inputs.size());
   m_activity_count++;
   return;
 }
@@ -100,11 +118,17 @@ TriggerCandidateMakerChannelAdjacency::configure(const nlohmann::json& config)
       m_readout_window_ticks_before = config["readout_window_ticks_before"];
     if (config.contains("readout_window_ticks_after"))
       m_readout_window_ticks_after = config["readout_window_ticks_after"];
+    if (config.contains("reference_inputs"))
+      m_reference_inputs = config["reference_inputs"];
+    if (config.contains("activity_store_size"))
+      m_activity_store.set_capacity(config["activity_store_size"]);
   }
+  // A TC is resolved as it leaves, so the store needs to hold the TAs of one window.
+  m_activity_store.set_retention(m_window_length);
 
   // Both trigger flags were false. This will never trigger.
   if (!m_trigger_on_adc && !m_trigger_on_n_channels) {
-    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:CA] Not triggering! All trigger flags are false!";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:CA] Not triggering! All trigger flags are false!";
     //throw BadConfiguration(ERS_HERE, TRACE_NAME);
   }
 
@@ -114,7 +138,7 @@ TriggerCandidateMakerChannelAdjacency::configure(const nlohmann::json& config)
 TriggerCandidate
 TriggerCandidateMakerChannelAdjacency::construct_tc() const
 {
-  TriggerActivity latest_ta_in_window = m_current_window.inputs.back();
+  const TriggerActivity& latest_ta_in_window = m_current_window.inputs.back();
 
   TriggerCandidate tc;
   tc.time_start = m_current_window.time_start - m_readout_window_ticks_before;
@@ -125,9 +149,16 @@ TriggerCandidateMakerChannelAdjacency::construct_tc() const
   tc.type = TriggerCandidate::Type::kChannelAdjacency;
   tc.algorithm = TriggerCandidate::Algorithm::kChannelAdjacency;
 
+  // In reference mode the TAs are already in the store, so just point at them.
+  if (m_reference_inputs) {
+    tc.input_refs = m_current_window.refs;
+    return tc;
+  }
+
   // Take the list of triggeralgs::TriggerActivity in the current
   // window and convert them (implicitly) to detdataformats'
   // TriggerActivityData, which is the base class of TriggerActivity
+  tc.inputs.reserve(m_current_window.inputs.size());
   for (auto& ta : m_current_window.inputs) {
     tc.inputs.push_back(ta);
   }
@@ -136,11 +167,13 @@ TriggerCandidateMakerChannelAdjacency::construct_tc() const
 }
 
 // Functions below this line are for debugging purposes.
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerCandidateMakerChannelAdjacency::add_window_to_record(TAWindow window)
 {
   m_window_record.push_back(window);
   return;
 }
+#endif
 
 REGISTER_TRIGGER_CANDIDATE_MAKER(TRACE_NAME, TriggerCandidateMakerChannelAdjacency)
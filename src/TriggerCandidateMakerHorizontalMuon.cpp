@@ -12,6 +12,7 @@
 #define TRACE_NAME "TriggerCandidateMakerHorizontalMuonPlugin"
 
 #include <math.h>
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -24,13 +25,37 @@ void
 TriggerCandidateMakerHorizontalMuon::operator()(const TriggerActivity& activity,
                                                 std::vector<TriggerCandidate>& output_tc)
 {
+  VectorSink<TriggerCandidate> sink(output_tc);
+  (*this)(TriggerActivity(activity), sink);
+}
+
+void
+TriggerCandidateMakerHorizontalMuon::operator()(TriggerActivity&& activity, std::vector<TriggerCandidate>& output_tc)
+{
+  VectorSink<TriggerCandidate> sink(output_tc);
+  (*this)(std::move(activity), sink);
+}
 
-  std::vector<TriggerActivity::TriggerActivityData> ta_list = { static_cast<TriggerActivity::TriggerActivityData>(
-    activity) };
+void
+TriggerCandidateMakerHorizontalMuon::operator()(const TriggerActivity& activity,
+                                                OutputSink<TriggerCandidate>& output_tc)
+{
+  // Every path below keeps the TA in the window, so copy it once here.
+  (*this)(TriggerActivity(activity), output_tc);
+}
+
+void
+TriggerCandidateMakerHorizontalMuon::operator()(TriggerActivity&& activity, OutputSink<TriggerCandidate>& output_tc)
+{
+  MakerMetrics::Scope scope(m_metrics);
+  ActivityRef ref = m_reference_inputs ? m_activity_store.add(activity) : ActivityRef();
+  // The TA itself is moved into the window below.
+  const timestamp_t now = activity.time_start;
+  m_metrics.record_arrival(now, 1);
 
   // The first time operator is called, reset window object.
   if (m_current_window.is_empty()) {
-    m_current_window.reset(activity);
+    m_current_window.reset(std::move(activity), ref);
     m_activity_count++;
 
     // TriggerCandidate tc = construct_tc();
@@ -43,14 +68,14 @@ TriggerCandidateMakerHorizontalMuon::operator()(const TriggerActivity& activity,
   // If the difference between the current TA's start time and the start of the window
   // is less than the specified window size, add the TA to the window.
   else if ((activity.time_start - m_current_window.time_start) < m_window_length) {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:HM] Window not yet complete, adding the activity to the window.";
-    m_current_window.add(activity);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:HM] Window not yet complete, adding the activity to the window.";
+    m_current_window.add(std::move(activity), ref);
   }
   // If it is not, move the window along.
   else {
-    TLOG_DEBUG(TLVL_DEBUG_ALL)
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL)
       << "[TCM:HM] TAWindow is at required length but specified threshold not met, shifting window along.";
-    m_current_window.move(activity, m_window_length);
+    m_current_window.move(std::move(activity), m_window_length, ref);
   }
 
   // If the addition of the current TA to the window would make it longer
@@ -59,19 +84,22 @@ TriggerCandidateMakerHorizontalMuon::operator()(const TriggerActivity& activity,
   // make a TA and start a fresh window with the current TP.
   if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
     // TLOG_DEBUG(TRACE_NAME) << "ADC integral in window is greater than specified threshold.";
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:HM] m_current_window.adc_integral " << m_current_window.adc_integral
-                                  << " - m_adc_threshold " << m_adc_threshold;
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:HM] m_current_window.adc_integral " << m_current_window.adc_integral
+                                              << " - m_adc_threshold " << m_adc_threshold;
+    m_metrics.count_trigger(0);
     tc_number++;
+    m_metrics.record_latency(now, m_current_window.inputs);
     TriggerCandidate tc = construct_tc();
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:HM] tc.time_start=" << tc.time_start << " tc.time_end=" << tc.time_end
-                                  << " len(tc.inputs) " << tc.inputs.size();
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:HM] tc.time_start=" << tc.time_start << " tc.time_end=" << tc.time_end
+                                              << " len(tc.inputs) " << tc.inputs.size();
 
     for (const auto& ta : tc.inputs) {
-      TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TCM:HM] [TA] ta.time_start=" << ta.time_start << " ta.time_end=" << ta.time_end
-                                 << " ta.adc_integral=" << ta.adc_integral;
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TCM:HM] [TA] ta.time_start=" << ta.time_start << " ta.time_end=" << ta.time_end
+                                             << " ta.adc_integral=" << ta.adc_integral;
     }
 
-    output_tc.push_back(tc);
+    output_tc.emit(std::move(tc));
+    m_metrics.count_outputs();
     // m_current_window.reset(activity);
     m_current_window.clear();
   }
@@ -81,8 +109,11 @@ TriggerCandidateMakerHorizontalMuon::operator()(const TriggerActivity& activity,
   // the existing window is above the specified threshold. If it is, and we are triggering on channels,
   // make a TC and start a fresh window with the current TA.
   else if (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels) {
+    m_metrics.count_trigger(1);
     tc_number++;
-    output_tc.push_back(construct_tc());
+    m_metrics.record_latency(now, m_current_window.inputs);
+    output_tc.emit(construct_tc());
+    m_metrics.count_outputs();
 
     // m_current_window.reset(activity);
     m_current_window.clear();
@@ -95,6 +126,7 @@ TriggerCandidateMakerHorizontalMuon::operator()(const TriggerActivity& activity,
   //   m_current_window.move(activity, m_window_length);
   // }
 
+  m_metrics.set_occupancy(m_current_window.inputs.size());
   m_activity_count++;
   return;
 }
@@ -117,13 +149,19 @@ TriggerCandidateMakerHorizontalMuon::configure(const nlohmann::json& config)
       m_readout_window_ticks_before = config["readout_window_ticks_before"];
     if (config.contains("readout_window_ticks_after"))
       m_readout_window_ticks_after = config["readout_window_ticks_after"];
+    if (config.contains("reference_inputs"))
+      m_reference_inputs = config["reference_inputs"];
+    if (config.contains("activity_store_size"))
+      m_activity_store.set_capacity(config["activity_store_size"]);
   }
+  // A TC is resolved as it leaves, so the store needs to hold the TAs of one window.
+  m_activity_store.set_retention(m_window_length);
   if (m_trigger_on_adc && m_trigger_on_n_channels) {
-    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:HM] Triggering on ADC count and number of channels is not supported.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:HM] Triggering on ADC count and number of channels is not supported.";
     //throw BadConfiguration(ERS_HERE, TRACE_NAME);
   }
   if (!m_trigger_on_adc && !m_trigger_on_n_channels) {
-    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:HM] Not triggering! All trigger flags are false!";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:HM] Not triggering! All trigger flags are false!";
     //throw BadConfiguration(ERS_HERE, TRACE_NAME);
   }
 
@@ -133,7 +171,7 @@ TriggerCandidateMakerHorizontalMuon::configure(const nlohmann::json& config)
 TriggerCandidate
 TriggerCandidateMakerHorizontalMuon::construct_tc() const
 {
-  TriggerActivity latest_ta_in_window = m_current_window.inputs.back();
+  const TriggerActivity& latest_ta_in_window = m_current_window.inputs.back();
 
   TriggerCandidate tc;
   tc.time_start = m_current_window.time_start - m_readout_window_ticks_before;
@@ -144,9 +182,16 @@ TriggerCandidateMakerHorizontalMuon::construct_tc() const
   tc.type = TriggerCandidate::Type::kHorizontalMuon;
   tc.algorithm = TriggerCandidate::Algorithm::kHorizontalMuon;
 
+  // In reference mode the TAs are already in the store, so just point at them.
+  if (m_reference_inputs) {
+    tc.input_refs = m_current_window.refs;
+    return tc;
+  }
+
   // Take the list of triggeralgs::TriggerActivity in the current
   // window and convert them (implicitly) to detdataformats'
   // TriggerActivityData, which is the base class of TriggerActivity
+  tc.inputs.reserve(m_current_window.inputs.size());
   for (auto& ta : m_current_window.inputs) {
     tc.inputs.push_back(ta);
   }
@@ -162,6 +207,7 @@ TriggerCandidateMakerHorizontalMuon::check_adjacency() const
 }
 
 // Functions below this line are for debugging purposes.
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerCandidateMakerHorizontalMuon::add_window_to_record(TAWindow window)
 {
@@ -191,28 +237,6 @@ TriggerCandidateMakerHorizontalMuon::dump_window_record()
 
   return;
 }
-
-/*
-void
-TriggerCandidateMakerHorizontalMuon::flush(timestamp_t, std::vector<TriggerCandidate>& output_tc)
-{
-  // Check the status of the current window, construct TC if conditions are met. Regardless
-  // of whether the conditions are met, reset the window.
-  if(m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc){
-  //else if(m_current_window.adc_integral > m_conf.adc_threshold && m_conf.trigger_on_adc){
-    //TLOG_DEBUG(TRACE_NAME) << "ADC integral in window is greater than specified threshold.";
-    output_tc.push_back(construct_tc());
-  }
-  else if(m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels){
-  //else if(m_current_window.n_channels_hit() > m_conf.n_channels_threshold && m_conf.trigger_on_n_channels){
-    //TLOG_DEBUG(TRACE_NAME) << "Number of channels hit in the window is greater than specified threshold.";
-    output_tc.push_back(construct_tc());
-  }
-
-  //TLOG_DEBUG(TRACE_NAME) << "Clearing the current window, on the arrival of the next input_tp, the window will be
-reset."; m_current_window.clear();
-
-  return;
-}*/
+#endif
 
 REGISTER_TRIGGER_CANDIDATE_MAKER(TRACE_NAME, TriggerCandidateMakerHorizontalMuon)
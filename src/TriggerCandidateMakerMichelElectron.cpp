@@ -11,6 +11,7 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerCandidateMakerMichelElectronPlugin"
 
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -24,6 +25,13 @@ using Logging::TLVL_VERY_IMPORTANT;
 void
 TriggerCandidateMakerMichelElectron::operator()(const TriggerActivity& activity,
                                                 std::vector<TriggerCandidate>& output_tc)
+{
+  // Every path below keeps the TA in the window, so copy it once here.
+  (*this)(TriggerActivity(activity), output_tc);
+}
+
+void
+TriggerCandidateMakerMichelElectron::operator()(TriggerActivity&& activity, std::vector<TriggerCandidate>& output_tc)
 {
 
   std::vector<TriggerActivity::TriggerActivityData> ta_list = { static_cast<TriggerActivity::TriggerActivityData>(
@@ -31,7 +39,7 @@ TriggerCandidateMakerMichelElectron::operator()(const TriggerActivity& activity,
 
   // The first time operator is called, reset window object.
   if (m_current_window.is_empty()) {
-    m_current_window.reset(activity);
+    m_current_window.reset(std::move(activity));
     m_activity_count++;
     // Trivial TC Logic:
     // If the request has been made to not trigger on number of channels or
@@ -40,7 +48,7 @@ TriggerCandidateMakerMichelElectron::operator()(const TriggerActivity& activity,
 
       // add_window_to_record(m_current_window);
       // dump_window_record();
-      TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ME] Constructing TC.";
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ME] Constructing TC.";
 
       TriggerCandidate tc = construct_tc();
       output_tc.push_back(tc);
@@ -57,20 +65,20 @@ TriggerCandidateMakerMichelElectron::operator()(const TriggerActivity& activity,
   // If the difference between the current TA's start time and the start of the window
   // is less than the specified window size, add the TA to the window.
   if ((activity.time_start - m_current_window.time_start) < m_window_length) {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] Window not yet complete, adding the activity to the window.";
-    m_current_window.add(activity);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] Window not yet complete, adding the activity to the window.";
+    m_current_window.add(std::move(activity));
   }
   // If the addition of the current TA to the window would make it longer
   // than the specified window length, don't add it but check whether the sum of all adc in
   // the existing window is above the specified threshold. If it is, and we are triggering on ADC,
   // make a TA and start a fresh window with the current TP.
   else if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ME] ADC integral in window is greater than specified threshold.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ME] ADC integral in window is greater than specified threshold.";
     TriggerCandidate tc = construct_tc();
 
     output_tc.push_back(tc);
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] Resetting window with activity.";
-    m_current_window.reset(activity);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] Resetting window with activity.";
+    m_current_window.reset(std::move(activity));
   }
   // If the addition of the current TA to the window would make it longer
   // than the specified window length, don't add it but check whether the number of hit channels in
@@ -79,13 +87,13 @@ TriggerCandidateMakerMichelElectron::operator()(const TriggerActivity& activity,
   else if (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels) {
     tc_number++;
     //   output_tc.push_back(construct_tc());
-    m_current_window.reset(activity);
-    TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TCM:ME] Should not see this!";
+    m_current_window.reset(std::move(activity));
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TCM:ME] Should not see this!";
   }
   // If it is not, move the window along.
   else {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] Window is at required length but specified threshold not met, shifting window along.";
-    m_current_window.move(activity, m_window_length);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] Window is at required length but specified threshold not met, shifting window along.";
+    m_current_window.move(std::move(activity), m_window_length);
   }
 
   //TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TCM:ME] " m_current_window;
@@ -120,11 +128,11 @@ TriggerCandidateMakerMichelElectron::configure(const nlohmann::json& config)
     // if (config.contains("channel_map")) m_channel_map = config["channel_map"];
   }
   if (m_trigger_on_adc && m_trigger_on_n_channels) {
-    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:ME] Triggering on ADC count and number of channels is not supported.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:ME] Triggering on ADC count and number of channels is not supported.";
     //throw BadConfiguration(ERS_HERE, TRACE_NAME);
   }
   if (!m_trigger_on_adc && !m_trigger_on_n_channels) {
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ME] Both trigger flags are false. Passing TAs through 1:1.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ME] Both trigger flags are false. Passing TAs through 1:1.";
   }
 
   return;
@@ -162,6 +170,7 @@ TriggerCandidateMakerMichelElectron::check_adjacency() const
 }
 
 // Functions below this line are for debugging purposes.
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerCandidateMakerMichelElectron::add_window_to_record(Window window)
 {
@@ -191,28 +200,20 @@ TriggerCandidateMakerMichelElectron::dump_window_record()
 
   return;
 }
+#endif
 
-/*
 void
-TriggerCandidateMakerMichelElectron::flush(timestamp_t, std::vector<TriggerCandidate>& output_tc)
+TriggerCandidateMakerMichelElectron::flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc)
 {
-  // Check the status of the current window, construct TC if conditions are met. Regardless
-  // of whether the conditions are met, reset the window.
-  if(m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc){
-  //else if(m_current_window.adc_integral > m_conf.adc_threshold && m_conf.trigger_on_adc){
-    //TLOG_DEBUG(TRACE_NAME) << "ADC integral in window is greater than specified threshold.";
-    output_tc.push_back(construct_tc());
-  }
-  else if(m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels){
-  //else if(m_current_window.n_channels_hit() > m_conf.n_channels_threshold && m_conf.trigger_on_n_channels){
-    //TLOG_DEBUG(TRACE_NAME) << "Number of channels hit in the window is greater than specified threshold.";
+  // Any TA at or after until would close the window, and only the ADC condition makes a TC.
+  if (m_current_window.is_empty() || until < m_current_window.time_start + m_window_length)
+    return;
+
+  if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:ME] ADC integral in flushed window is greater than specified threshold.";
     output_tc.push_back(construct_tc());
+    m_current_window.clear();
   }
-
-  //TLOG_DEBUG(TRACE_NAME) << "Clearing the current window, on the arrival of the next input_tp, the window will be
-reset."; m_current_window.clear();
-
-  return;
-}*/
+}
 
 REGISTER_TRIGGER_CANDIDATE_MAKER(TRACE_NAME, TriggerCandidateMakerMichelElectron)
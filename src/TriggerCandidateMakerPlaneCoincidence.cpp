@@ -11,6 +11,7 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerCandidateMakerPlaneCoincidencePlugin"
 
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -24,6 +25,13 @@ using Logging::TLVL_VERY_IMPORTANT;
 void
 TriggerCandidateMakerPlaneCoincidence::operator()(const TriggerActivity& activity,
                                                 std::vector<TriggerCandidate>& output_tc)
+{
+  // Every path below keeps the TA in the window, so copy it once here.
+  (*this)(TriggerActivity(activity), output_tc);
+}
+
+void
+TriggerCandidateMakerPlaneCoincidence::operator()(TriggerActivity&& activity, std::vector<TriggerCandidate>& output_tc)
 {
 
   std::vector<TriggerActivity::TriggerActivityData> ta_list = { static_cast<TriggerActivity::TriggerActivityData>(
@@ -31,7 +39,7 @@ TriggerCandidateMakerPlaneCoincidence::operator()(const TriggerActivity& activit
 
   // The first time operator is called, reset window object.
   if (m_current_window.is_empty()) {
-    m_current_window.reset(activity);
+    m_current_window.reset(std::move(activity));
     m_activity_count++;
     // Trivial TC Logic:
     // If the request has been made to not trigger on number of channels or
@@ -40,8 +48,8 @@ TriggerCandidateMakerPlaneCoincidence::operator()(const TriggerActivity& activit
 
       // add_window_to_record(m_current_window);
       // dump_window_record();
-      TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:PC] Constructing TC.";
-      TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:PC] Activity count: " << m_activity_count;
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:PC] Constructing TC.";
+      TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:PC] Activity count: " << m_activity_count;
       TriggerCandidate tc = construct_tc();
       output_tc.push_back(tc);
 
@@ -57,19 +65,19 @@ TriggerCandidateMakerPlaneCoincidence::operator()(const TriggerActivity& activit
   // If the difference between the current TA's start time and the start of the window
   // is less than the specified window size, add the TA to the window.
   if ((activity.time_start - m_current_window.time_start) < m_window_length) {
-    m_current_window.add(activity);
+    m_current_window.add(std::move(activity));
   }
   // If the addition of the current TA to the window would make it longer
   // than the specified window length, don't add it but check whether the sum of all adc in
   // the existing window is above the specified threshold. If it is, and we are triggering on ADC,
   // make a TA and start a fresh window with the current TP.
   else if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
-    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:PC] ADC integral in window is greater than specified threshold.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:PC] ADC integral in window is greater than specified threshold.";
     TriggerCandidate tc = construct_tc();
 
     output_tc.push_back(tc);
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:PC] Resetting window with activity.";
-    m_current_window.reset(activity);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:PC] Resetting window with activity.";
+    m_current_window.reset(std::move(activity));
   }
   // If the addition of the current TA to the window would make it longer
   // than the specified window length, don't add it but check whether the number of hit channels in
@@ -79,13 +87,13 @@ TriggerCandidateMakerPlaneCoincidence::operator()(const TriggerActivity& activit
     // TODO 04-2024: This case appears unsupported. Throwing error for now, but should this be removed?
     tc_number++;
     //   output_tc.push_back(construct_tc());
-    m_current_window.reset(activity);
-    TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TCM:PC] Should not see this!";
+    m_current_window.reset(std::move(activity));
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TCM:PC] Should not see this!";
   }
   // If it is not, move the window along.
   else {
-    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:PC] TAWindow is at required length but specified threshold not met, shifting window along.";
-    m_current_window.move(activity, m_window_length);
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:PC] TAWindow is at required length but specified threshold not met, shifting window along.";
+    m_current_window.move(std::move(activity), m_window_length);
   }
 
   m_activity_count++;
@@ -93,6 +101,20 @@ TriggerCandidateMakerPlaneCoincidence::operator()(const TriggerActivity& activit
   return;
 }
 
+void
+TriggerCandidateMakerPlaneCoincidence::flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc)
+{
+  // Any TA at or after until would close the window, and only the ADC condition makes a TC.
+  if (m_current_window.is_empty() || until < m_current_window.time_start + m_window_length)
+    return;
+
+  if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TCM:PC] ADC integral in flushed window is greater than specified threshold.";
+    output_tc.push_back(construct_tc());
+    m_current_window.clear();
+  }
+}
+
 void
 TriggerCandidateMakerPlaneCoincidence::configure(const nlohmann::json& config)
 {
@@ -114,11 +136,11 @@ TriggerCandidateMakerPlaneCoincidence::configure(const nlohmann::json& config)
 
   }
   if (m_trigger_on_n_channels) {
-    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:PC] Using trigger_on_n_channels is not supported.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TCM:PC] Using trigger_on_n_channels is not supported.";
     //throw BadConfiguration(ERS_HERE, TRACE_NAME);
   }
   if (!m_trigger_on_adc && !m_trigger_on_n_channels) {
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:PC] Both trigger flags are false. Passing TAs through 1:1.";
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:PC] Both trigger flags are false. Passing TAs through 1:1.";
   }
 
   return;
@@ -156,6 +178,7 @@ TriggerCandidateMakerPlaneCoincidence::check_adjacency() const
 }
 
 // Functions below this line are for debugging purposes.
+#ifndef TRIGGERALGS_NO_DIAGNOSTICS
 void
 TriggerCandidateMakerPlaneCoincidence::add_window_to_record(TAWindow window)
 {
@@ -185,5 +208,6 @@ TriggerCandidateMakerPlaneCoincidence::dump_window_record()
 
   return;
 }
+#endif
 
 REGISTER_TRIGGER_CANDIDATE_MAKER(TRACE_NAME, TriggerCandidateMakerPlaneCoincidence)
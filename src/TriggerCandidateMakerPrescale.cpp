@@ -11,6 +11,7 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerCandidateMakerPrescalePlugin"
 
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -21,11 +22,41 @@ using Logging::TLVL_IMPORTANT;
 void
 TriggerCandidateMakerPrescale::operator()(const TriggerActivity& activity, std::vector<TriggerCandidate>& cand)
 {
-  if ((m_activity_count++) % m_prescale == 0) {
-    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:Pr] Emitting prescaled TriggerCandidate " << (m_activity_count - 1);
+  VectorSink<TriggerCandidate> sink(cand);
+  make_candidate(activity, sink);
+}
+
+void
+TriggerCandidateMakerPrescale::operator()(const TriggerActivity& activity, OutputSink<TriggerCandidate>& cand)
+{
+  make_candidate(activity, cand);
+}
+
+void
+TriggerCandidateMakerPrescale::operator()(TriggerActivity&& activity, OutputSink<TriggerCandidate>& cand)
+{
+  make_candidate(activity, cand);
+}
 
-    std::vector<TriggerActivity::TriggerActivityData> ta_list;
-    ta_list.push_back(static_cast<TriggerActivity::TriggerActivityData>(activity));
+void
+TriggerCandidateMakerPrescale::operator()(const ActivityView& activity, std::vector<TriggerCandidate>& cand)
+{
+  if (!activity.is_valid()) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TCM:Pr] Skipping a TriggerActivity overlay that overruns its buffer";
+    m_metrics.count_drops();
+    return;
+  }
+  VectorSink<TriggerCandidate> sink(cand);
+  make_candidate(activity.data(), sink);
+}
+
+void
+TriggerCandidateMakerPrescale::make_candidate(const TriggerActivity::TriggerActivityData& activity,
+                                              OutputSink<TriggerCandidate>& cand)
+{
+  MakerMetrics::Scope scope(m_metrics);
+  if ((m_activity_count++) % m_prescale == 0) {
+    TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:Pr] Emitting prescaled TriggerCandidate " << (m_activity_count - 1);
 
     TriggerCandidate tc;
     tc.time_start = activity.time_start - m_readout_window_ticks_before;
@@ -35,9 +66,12 @@ TriggerCandidateMakerPrescale::operator()(const TriggerActivity& activity, std::
     tc.type = TriggerCandidate::Type::kPrescale;
     tc.algorithm = TriggerCandidate::Algorithm::kPrescale;
 
-    tc.inputs = ta_list;
+    tc.inputs.push_back(activity);
 
-    cand.push_back(tc);
+    cand.emit(std::move(tc));
+    m_metrics.count_outputs();
+  } else {
+    m_metrics.count_drops();
   }
 }
 
@@ -51,7 +85,7 @@ TriggerCandidateMakerPrescale::configure(const nlohmann::json& config)
     if (config.contains("readout_window_ticks_after"))
       m_readout_window_ticks_after = config["readout_window_ticks_after"];
   }
-  TLOG_DEBUG(TLVL_IMPORTANT) << "[TCM:Pr] Using candidate prescale " << m_prescale;
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TCM:Pr] Using candidate prescale " << m_prescale;
 }
 
 REGISTER_TRIGGER_CANDIDATE_MAKER(TRACE_NAME, TriggerCandidateMakerPrescale)
@@ -19,10 +19,10 @@ TriggerCandidateMakerSupernova::operator()(const TriggerActivity& activity, std:
   timestamp_t time = activity.time_start;
   FlushOldActivity(time); // get rid of old activities in the buffer
   if (activity.inputs.size() > m_hit_threshold)
-    m_activity.push_back(static_cast<TriggerActivity::TriggerActivityData>(activity));
+    AddActivity(static_cast<TriggerActivity::TriggerActivityData>(activity));
 
   // Yay! we have a trigger!
-  if (m_activity.size() > m_threshold) {
+  if (ActivityCount() > m_threshold) {
 
     detid_t detid = dunedaq::trgdataformats::WHOLE_DETECTOR;
 
@@ -33,11 +33,10 @@ TriggerCandidateMakerSupernova::operator()(const TriggerActivity& activity, std:
     tc.detid = detid;
     tc.type = TriggerCandidate::Type::kSupernova; // type ( flag that says what type of trigger might be (e.g. SN/Muon/Beam) )
     tc.algorithm = TriggerCandidate::Algorithm::kSupernova; // algorithm ( flag that says which algorithm created the trigger (e.g. SN/HE/Solar) )
-    tc.inputs =  m_activity;
+    tc.inputs = TakeActivity();
 
-    m_activity.clear();
     // Give the trigger word back
-    cand.push_back(tc);
+    cand.push_back(std::move(tc));
   }
 }
 
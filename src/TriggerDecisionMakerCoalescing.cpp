@@ -0,0 +1,145 @@
+/**
+ * @file TriggerDecisionMakerCoalescing.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/Coalescing/TriggerDecisionMakerCoalescing.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "TriggerDecisionMakerCoalescingPlugin"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+using namespace triggeralgs;
+
+using Logging::TLVL_DEBUG_HIGH;
+using Logging::TLVL_IMPORTANT;
+
+void
+TriggerDecisionMakerCoalescing::operator()(const TriggerCandidate& input_tc, std::vector<TriggerDecision>& output_tds)
+{
+  MakerMetrics::Scope scope(m_metrics);
+
+  // Data time only moves forward with the candidates and flushes, so this is the point to
+  // release the decisions that have used up their latency.
+  release(input_tc.time_candidate, output_tds);
+  timestamp_t now = m_data_time;
+
+  // Find the pending decisions this candidate's readout window overlaps. As the pending
+  // windows don't overlap each other, those are consecutive in m_pending.
+  timestamp_t lower = input_tc.time_start > m_merge_gap ? input_tc.time_start - m_merge_gap : 0;
+  timestamp_t upper = input_tc.time_end + m_merge_gap;
+
+  auto first = m_pending.upper_bound(lower);
+  if (first != m_pending.begin() && std::prev(first)->second.td.time_end >= lower)
+    --first;
+
+  if (first == m_pending.end() || first->first > upper) {
+    PendingDecision& pending = m_pending[input_tc.time_start];
+    pending.opened = now;
+    pending.td.time_start = input_tc.time_start;
+    pending.td.time_end = input_tc.time_end;
+    pending.td.time_trigger = input_tc.time_candidate;
+    pending.td.type = static_cast<uint32_t>(input_tc.type); // NOLINT(build/unsigned)
+    pending.td.algorithm = static_cast<uint32_t>(input_tc.algorithm); // NOLINT(build/unsigned)
+    pending.td.version = input_tc.version;
+    pending.td.tc_list.push_back(input_tc);
+    m_pending_age.emplace(now, input_tc.time_start);
+    m_metrics.set_occupancy(m_pending.size());
+    return;
+  }
+
+  // Merge the candidate, and any further decisions it bridges, into the first overlapping one.
+  PendingDecision& pending = first->second;
+  for (auto next = std::next(first); next != m_pending.end() && next->first <= upper;) {
+    TriggerDecision& other = next->second.td;
+    m_pending_age.erase({ next->second.opened, next->first });
+    if (next->second.opened < pending.opened) {
+      m_pending_age.erase({ pending.opened, first->first });
+      pending.opened = next->second.opened;
+      m_pending_age.emplace(pending.opened, first->first);
+    }
+    pending.td.time_end = std::max(pending.td.time_end, other.time_end);
+    pending.td.time_trigger = std::min(pending.td.time_trigger, other.time_trigger);
+    pending.td.tc_list.insert(pending.td.tc_list.end(),
+                              std::make_move_iterator(other.tc_list.begin()),
+                              std::make_move_iterator(other.tc_list.end()));
+    next = m_pending.erase(next);
+  }
+
+  pending.td.time_end = std::max(pending.td.time_end, input_tc.time_end);
+  pending.td.time_trigger = std::min(pending.td.time_trigger, input_tc.time_candidate);
+  pending.td.tc_list.push_back(input_tc);
+
+  // Re-key the decision if the candidate starts its readout earlier.
+  if (input_tc.time_start < first->first) {
+    m_pending_age.erase({ pending.opened, first->first });
+    m_pending_age.emplace(pending.opened, input_tc.time_start);
+    pending.td.time_start = input_tc.time_start;
+    auto node = m_pending.extract(first);
+    node.key() = input_tc.time_start;
+    m_pending.insert(std::move(node));
+  }
+  m_metrics.set_occupancy(m_pending.size());
+}
+
+void
+TriggerDecisionMakerCoalescing::flush(std::vector<TriggerDecision>& output_tds)
+{
+  while (!m_pending_age.empty()) {
+    emit(m_pending.find(m_pending_age.begin()->second), output_tds);
+  }
+  m_metrics.set_occupancy(0);
+}
+
+void
+TriggerDecisionMakerCoalescing::flush(timestamp_t until, std::vector<TriggerDecision>& output_tds)
+{
+  release(until, output_tds);
+  m_metrics.set_occupancy(m_pending.size());
+}
+
+void
+TriggerDecisionMakerCoalescing::release(timestamp_t now, std::vector<TriggerDecision>& output_tds)
+{
+  m_data_time = std::max(m_data_time, now);
+  while (!m_pending_age.empty() && m_data_time - m_pending_age.begin()->first >= m_latency) {
+    emit(m_pending.find(m_pending_age.begin()->second), output_tds);
+  }
+}
+
+void
+TriggerDecisionMakerCoalescing::emit(std::map<timestamp_t, PendingDecision>::iterator it,
+                                     std::vector<TriggerDecision>& output_tds)
+{
+  m_pending_age.erase({ it->second.opened, it->first });
+
+  TriggerDecision& td = it->second.td;
+  td.trigger_number = m_trigger_number++;
+  TRIGGERALGS_TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TDM:CO] Emitting decision " << td.trigger_number << " covering ["
+                                          << td.time_start << ", " << td.time_end << "] from " << td.tc_list.size()
+                                          << " candidates.";
+  output_tds.push_back(std::move(td));
+  m_metrics.count_outputs();
+  m_pending.erase(it);
+}
+
+void
+TriggerDecisionMakerCoalescing::configure(const nlohmann::json& config)
+{
+  if (config.is_object()) {
+    if (config.contains("latency"))
+      m_latency = config["latency"];
+    if (config.contains("merge_gap"))
+      m_merge_gap = config["merge_gap"];
+  }
+  TRIGGERALGS_TLOG_DEBUG(TLVL_IMPORTANT) << "[TDM:CO] Merging candidates within " << m_merge_gap << " ticks, holding them for up to "
+                                         << m_latency << " ticks.";
+}
+
+REGISTER_TRIGGER_DECISION_MAKER(TRACE_NAME, TriggerDecisionMakerCoalescing)
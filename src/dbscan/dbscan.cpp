@@ -262,13 +262,32 @@ IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_cluster
     }
 
 
+    complete_clusters(m_latest_time, completed_clusters);
+}
+
+//======================================================================
+void
+IncrementalDBSCAN::flush(uint64_t until, std::vector<Cluster>* completed_clusters)
+{
+    // Nothing added yet
+    if (m_first_prim_time == 0 || until < m_first_prim_time) {
+        return;
+    }
+    // Same time scale as add_primitive()
+    complete_clusters(1e-2 * (until - m_first_prim_time), completed_clusters);
+}
+
+//======================================================================
+void
+IncrementalDBSCAN::complete_clusters(float latest_time, std::vector<Cluster>* completed_clusters)
+{
     // Delete any completed clusters from the list. Put them in the
     // `completed_clusters` vector, if that vector was passed
     auto clust_it = m_clusters.begin();
     while (clust_it != m_clusters.end()) {
         Cluster& cluster = clust_it->second;
 
-        if (cluster.latest_time < m_latest_time - m_eps) {
+        if (cluster.latest_time < latest_time - m_eps) {
             cluster.completeness = Completeness::kComplete;
         }
 
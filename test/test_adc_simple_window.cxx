@@ -0,0 +1,137 @@
+/**
+ * @file test_adc_simple_window.cxx
+ *
+ * Checks the bucketed mode of TriggerActivityMakerADCSimpleWindow against a reference that
+ * keeps every TP since the last TA and sums each window from scratch.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_adc_simple_window
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+class ReferenceBucketed
+{
+public:
+  ReferenceBucketed(timestamp_t bucket_width, std::vector<timestamp_t> window_lengths, std::vector<uint64_t> adc_thresholds)
+    : m_bucket_width(bucket_width)
+    , m_adc_thresholds(adc_thresholds)
+  {
+    for (timestamp_t length : window_lengths)
+      m_window_buckets.push_back(std::max<int64_t>(1, length / bucket_width));
+  }
+
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_tas)
+  {
+    int64_t bucket = input_tp.time_start / m_bucket_width;
+    if (!m_tps.empty() && bucket < m_current_bucket) {
+      ++m_n_drops;
+      return;
+    }
+    m_current_bucket = m_tps.empty() ? bucket : std::max(m_current_bucket, bucket);
+    m_tps.push_back(input_tp);
+
+    for (size_t i = 0; i < m_window_buckets.size(); ++i) {
+      TriggerActivity ta;
+      for (const auto& tp : m_tps)
+        if (static_cast<int64_t>(tp.time_start / m_bucket_width) > m_current_bucket - m_window_buckets[i]) {
+          ta.inputs.push_back(tp);
+          ta.adc_integral += tp.adc_integral;
+        }
+      if (ta.adc_integral <= m_adc_thresholds[i])
+        continue;
+
+      const TriggerPrimitive& last_tp = ta.inputs.back();
+      ta.time_start = ta.inputs.front().time_start;
+      ta.time_end = last_tp.time_start + last_tp.time_over_threshold;
+      ta.time_peak = last_tp.time_peak;
+      ta.time_activity = last_tp.time_peak;
+      ta.channel_start = last_tp.channel;
+      ta.channel_end = last_tp.channel;
+      ta.channel_peak = last_tp.channel;
+      ta.adc_peak = last_tp.adc_peak;
+      ta.detid = last_tp.detid;
+      ta.type = TriggerActivity::Type::kTPC;
+      ta.algorithm = TriggerActivity::Algorithm::kADCSimpleWindow;
+      output_tas.push_back(ta);
+      m_tps.clear();
+      return;
+    }
+  }
+
+  uint64_t get_n_drops() const { return m_n_drops; }
+
+private:
+  timestamp_t m_bucket_width;
+  std::vector<int64_t> m_window_buckets;
+  std::vector<uint64_t> m_adc_thresholds;
+  std::vector<TriggerPrimitive> m_tps;
+  int64_t m_current_bucket = 0;
+  uint64_t m_n_drops = 0;
+};
+
+// Returns the number of TPs dropped.
+uint64_t
+check_against_reference(const std::vector<TriggerPrimitive>& tps,
+                        timestamp_t bucket_width,
+                        const std::vector<timestamp_t>& window_lengths,
+                        const std::vector<uint64_t>& adc_thresholds)
+{
+  BOOST_TEST_CONTEXT("bucket_width " << bucket_width << ", " << window_lengths.size() << " windows")
+  {
+    auto maker = TriggerActivityFactory::get_instance()->build_maker("TriggerActivityMakerADCSimpleWindowPlugin");
+    BOOST_REQUIRE(maker);
+    maker->configure({ { "bucket_width", bucket_width },
+                       { "window_lengths", window_lengths },
+                       { "adc_thresholds", adc_thresholds } });
+    maker->enable_metrics();
+    ReferenceBucketed reference(bucket_width, window_lengths, adc_thresholds);
+
+    std::vector<TriggerActivity> tas, reference_tas;
+    for (const auto& tp : tps) {
+      (*maker)(tp, tas);
+      reference(tp, reference_tas);
+    }
+    BOOST_TEST(reference_tas.size() > 10u);
+    test::check_same_tas(tas, reference_tas);
+    BOOST_TEST(maker->get_metrics()["drops"].get<uint64_t>() == reference.get_n_drops());
+    return reference.get_n_drops();
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_tas_as_reference)
+{
+  for (unsigned seed = 1; seed <= 3; ++seed) {
+    auto tps = test::make_tp_stream(seed);
+    for (timestamp_t bucket_width : { 7, 50, 400 }) {
+      check_against_reference(tps, bucket_width, { 1000 }, { 18000 });
+      check_against_reference(tps, bucket_width, { 400, 1000, 3000 }, { 8000, 20000, 60000 });
+    }
+  }
+}
+
+// TPs a few places out of time order: those from a bucket before the latest one are dropped.
+BOOST_AUTO_TEST_CASE(late_tps_dropped)
+{
+  auto tps = test::shuffle_locally(test::make_tp_stream(4), 2, 4);
+  for (timestamp_t bucket_width : { 7, 50, 400 })
+    BOOST_TEST(check_against_reference(tps, bucket_width, { 400, 1000, 3000 }, { 8000, 20000, 60000 }) > 0u);
+}
+
+} // namespace triggeralgs
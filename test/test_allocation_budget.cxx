@@ -0,0 +1,166 @@
+/**
+ * @file test_allocation_budget.cxx
+ *
+ * Replays a small TP capture twice through the Prescale and HorizontalMuon makers with
+ * allocation counting on, and checks that on the second pass, once their windows and channel
+ * maps have grown to what the data needs, they only allocate for what they make: an input that
+ * makes nothing costs no allocations, and each TA or TC made at most one, for the list of inputs
+ * it carries.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_allocation_budget
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/AllocationCounter.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPCapture.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+std::string
+capture_path()
+{
+  return (std::filesystem::temp_directory_path() / "test_allocation_budget.tpc").string();
+}
+
+// What one maker allocated on the second pass.
+struct Allocations
+{
+  uint64_t n_inputs = 0;
+  uint64_t n_outputs = 0;
+  uint64_t n_allocations = 0;
+  uint64_t n_inputs_over_budget = 0; // Inputs costing more than one allocation per output
+
+  void add(const AllocationScope& scope, size_t n_new_outputs)
+  {
+    uint64_t n = scope.get().n_allocations;
+    n_inputs++;
+    n_outputs += n_new_outputs;
+    n_allocations += n;
+    if (n > n_new_outputs)
+      n_inputs_over_budget++;
+  }
+};
+
+void
+check_budget(const Allocations& allocations)
+{
+  BOOST_TEST(allocations.n_inputs > 0u);
+  BOOST_TEST(allocations.n_outputs > 0u);
+  BOOST_TEST(allocations.n_allocations <= allocations.n_outputs);
+  BOOST_TEST(allocations.n_inputs_over_budget == 0u);
+}
+
+// Records a TP stream as a capture and replays it twice through a TA maker and a TC maker, as
+// run_replay does, counting what each maker allocates on the second pass. That pass is moved on
+// in time past the end of the first, so the makers see it as more of the same data.
+std::pair<Allocations, Allocations>
+replay(const std::string& activity_maker,
+       const nlohmann::json& activity_config,
+       const std::string& candidate_maker,
+       const nlohmann::json& candidate_config)
+{
+  test::StreamConfig stream;
+  stream.n_tps = 50000;
+  const auto stream_tps = test::make_tp_stream(1, stream);
+  const timestamp_t pass_length = stream_tps.back().time_start + 100000;
+  {
+    TPCaptureWriter writer;
+    BOOST_REQUIRE(writer.open(capture_path()));
+    for (const auto& tp : stream_tps)
+      writer.write(tp);
+    BOOST_REQUIRE(writer.close());
+  }
+
+  auto ta_maker = TriggerActivityFactory::get_instance()->build_maker(activity_maker);
+  auto tc_maker = TriggerCandidateFactory::get_instance()->build_maker(candidate_maker);
+  BOOST_REQUIRE(ta_maker);
+  BOOST_REQUIRE(tc_maker);
+  ta_maker->configure(activity_config);
+  tc_maker->configure(candidate_config);
+
+  TPCaptureReader reader;
+  BOOST_REQUIRE(reader.open(capture_path()));
+  Allocations ta_allocations, tc_allocations;
+  std::vector<TriggerPrimitive> tps;
+  std::vector<TriggerActivity> tas;
+  std::vector<TriggerCandidate> tcs;
+  uint64_t n_tps = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    const bool steady = pass == 1;
+    for (size_t block = 0; reader.read_block(block, tps); ++block) {
+      for (auto& tp : tps) {
+        tp.time_start += pass * pass_length;
+        tp.time_peak += pass * pass_length;
+        n_tps++;
+        AllocationScope ta_scope;
+        (*ta_maker)(tp, tas);
+        if (steady)
+          ta_allocations.add(ta_scope, tas.size());
+
+        for (auto& ta : tas) {
+          AllocationScope tc_scope;
+          (*tc_maker)(std::move(ta), tcs);
+          if (steady)
+            tc_allocations.add(tc_scope, tcs.size());
+          tcs.clear();
+        }
+        tas.clear();
+      }
+    }
+  }
+  BOOST_TEST(n_tps == 2 * stream.n_tps);
+  std::filesystem::remove(capture_path());
+  return { ta_allocations, tc_allocations };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(counting_enabled)
+{
+  BOOST_REQUIRE(allocation_counting_enabled());
+  AllocationScope scope;
+  std::vector<int> v(10);
+  BOOST_TEST(scope.get().n_allocations == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(prescale_steady_state)
+{
+  BOOST_REQUIRE(allocation_counting_enabled());
+  auto [ta_allocations, tc_allocations] = replay("TriggerActivityMakerPrescalePlugin",
+                                                 { { "prescale", 100 } },
+                                                 "TriggerCandidateMakerPrescalePlugin",
+                                                 { { "prescale", 5 } });
+  BOOST_TEST_CONTEXT("activity maker") { check_budget(ta_allocations); }
+  BOOST_TEST_CONTEXT("candidate maker") { check_budget(tc_allocations); }
+}
+
+BOOST_AUTO_TEST_CASE(horizontal_muon_steady_state)
+{
+  BOOST_REQUIRE(allocation_counting_enabled());
+  auto [ta_allocations, tc_allocations] =
+    replay("TriggerActivityMakerHorizontalMuonPlugin",
+           { { "window_length", 400 }, { "adjacency_threshold", 8 } },
+           "TriggerCandidateMakerHorizontalMuonPlugin",
+           { { "trigger_on_adc", true }, { "adc_threshold", 20000 }, { "window_length", 2000 } });
+  BOOST_TEST_CONTEXT("activity maker") { check_budget(ta_allocations); }
+  BOOST_TEST_CONTEXT("candidate maker") { check_budget(tc_allocations); }
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,269 @@
+/**
+ * @file test_channel_adjacency.cxx
+ *
+ * Checks that the one-pass track extraction in TriggerActivityMakerChannelAdjacency gives the
+ * same TAs as the original algorithm, which found one track at a time and removed its
+ * channels from the window before looking again.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_channel_adjacency
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPWindow.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// The original ChannelAdjacency TA maker, kept as the reference.
+class ReferenceChannelAdjacency
+{
+public:
+  ReferenceChannelAdjacency(timestamp_t window_length, uint16_t adjacency_threshold, uint16_t adj_tolerance, uint16_t prescale)
+    : m_window_length(window_length)
+    , m_adjacency_threshold(adjacency_threshold)
+    , m_adj_tolerance(adj_tolerance)
+    , m_prescale(prescale)
+  {}
+
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+  {
+    if (m_current_window.is_empty()) {
+      m_current_window.reset(input_tp);
+      return;
+    }
+
+    bool adj_pass = 0;
+    bool window_filled = 1;
+    if ((input_tp.time_start - m_current_window.time_start) < m_window_length) {
+      m_current_window.add(input_tp);
+      window_filled = 0;
+    } else {
+      TPWindow win_adj_max;
+
+      bool ta_found = 1;
+      while (ta_found) {
+        TPWindow m_current_window_tmp = m_current_window;
+        m_current_window.clear();
+        for (auto tp : m_current_window_tmp.inputs) {
+          bool new_tp = 1;
+          for (auto tp_sel : win_adj_max.inputs) {
+            if (tp.channel == tp_sel.channel) {
+              new_tp = 0;
+              break;
+            }
+          }
+          if (new_tp)
+            m_current_window.add(tp);
+        }
+
+        win_adj_max = check_adjacency();
+        if (win_adj_max.inputs.size() > 0) {
+          adj_pass = 1;
+          ta_found = 1;
+          m_ta_count++;
+          if (m_ta_count % m_prescale == 0) {
+            output_ta.push_back(construct_ta(win_adj_max));
+          }
+        } else
+          ta_found = 0;
+      }
+      if (adj_pass)
+        m_current_window.reset(input_tp);
+    }
+
+    if (window_filled && !adj_pass) {
+      m_current_window.move(input_tp, m_window_length);
+    }
+  }
+
+private:
+  TriggerActivity construct_ta(TPWindow win_adj_max) const
+  {
+    TriggerActivity ta;
+    TriggerPrimitive last_tp = win_adj_max.inputs.back();
+
+    ta.time_start = last_tp.time_start;
+    ta.time_end = last_tp.time_start;
+    ta.time_peak = last_tp.time_peak;
+    ta.time_activity = last_tp.time_peak;
+    ta.channel_start = last_tp.channel;
+    ta.channel_end = last_tp.channel;
+    ta.channel_peak = last_tp.channel;
+    ta.adc_integral = win_adj_max.adc_integral;
+    ta.adc_peak = last_tp.adc_peak;
+    ta.detid = last_tp.detid;
+    ta.type = TriggerActivity::Type::kTPC;
+    ta.algorithm = TriggerActivity::Algorithm::kChannelAdjacency;
+    ta.inputs = win_adj_max.inputs;
+
+    for (const auto& tp : ta.inputs) {
+      ta.time_start = std::min(ta.time_start, tp.time_start);
+      ta.time_end = std::max(ta.time_end, tp.time_start);
+      ta.channel_start = std::min(ta.channel_start, tp.channel);
+      ta.channel_end = std::max(ta.channel_end, tp.channel);
+      if (tp.adc_peak > ta.adc_peak) {
+        ta.time_peak = tp.time_peak;
+        ta.adc_peak = tp.adc_peak;
+        ta.channel_peak = tp.channel;
+      }
+    }
+    return ta;
+  }
+
+  TPWindow check_adjacency()
+  {
+    unsigned int channel = 0;
+    unsigned int next_channel = 0;
+    unsigned int next = 0;
+    unsigned int tol_count = 0;
+
+    std::vector<std::pair<int, TriggerPrimitive>> chanTPList;
+    for (auto tp : m_current_window.inputs) {
+      chanTPList.push_back(std::make_pair(tp.channel, tp));
+    }
+    // The original used std::sort, which leaves the order of TPs on the same channel, and so
+    // which of them go into a track, unspecified. Keep them in window order, as the maker does.
+    std::stable_sort(chanTPList.begin(),
+                     chanTPList.end(),
+                     [](const std::pair<int, TriggerPrimitive>& a, const std::pair<int, TriggerPrimitive>& b) {
+                       return (a.first < b.first);
+                     });
+
+    // The original left win_adj's adc_integral uninitialised until its first clear().
+    TPWindow win_adj;
+    TPWindow win_adj_max;
+    win_adj.clear();
+
+    for (size_t i = 0; i < chanTPList.size(); ++i) {
+      win_adj_max.clear();
+
+      next = (i + 1) % chanTPList.size();
+      channel = chanTPList.at(i).first;
+      next_channel = chanTPList.at(next).first;
+
+      if (next == 0) {
+        next_channel = channel - 1;
+      }
+
+      if (next_channel == channel)
+        continue;
+
+      if (win_adj.inputs.size() == 0)
+        win_adj.add(chanTPList[i].second);
+
+      if (next_channel - channel == 1) {
+        win_adj.add(chanTPList[next].second);
+      } else if (next_channel - channel > 0 && next_channel - channel <= 5 && tol_count < m_adj_tolerance) {
+        win_adj.add(chanTPList[next].second);
+        tol_count += next_channel - channel - 1;
+      } else if (win_adj.inputs.size() > m_adjacency_threshold) {
+        win_adj_max = win_adj;
+        break;
+      } else {
+        tol_count = 0;
+        win_adj.clear();
+      }
+    }
+
+    return win_adj_max;
+  }
+
+  TPWindow m_current_window;
+  timestamp_t m_window_length;
+  uint16_t m_adjacency_threshold;
+  uint16_t m_adj_tolerance;
+  uint16_t m_prescale;
+  uint16_t m_ta_count = 0;
+};
+
+void
+check_against_reference(const std::vector<TriggerPrimitive>& tps,
+                        timestamp_t window_length,
+                        uint16_t adjacency_threshold,
+                        uint16_t adj_tolerance,
+                        uint16_t prescale = 1)
+{
+  BOOST_TEST_CONTEXT("window_length " << window_length << ", adjacency_threshold " << adjacency_threshold
+                                      << ", adj_tolerance " << adj_tolerance << ", prescale " << prescale)
+  {
+    auto maker = TriggerActivityFactory::get_instance()->build_maker("TriggerActivityMakerChannelAdjacencyPlugin");
+    BOOST_REQUIRE(maker);
+    maker->configure({ { "window_length", window_length },
+                       { "adjacency_threshold", adjacency_threshold },
+                       { "adj_tolerance", adj_tolerance },
+                       { "prescale", prescale } });
+    ReferenceChannelAdjacency reference(window_length, adjacency_threshold, adj_tolerance, prescale);
+
+    std::vector<TriggerActivity> tas, reference_tas;
+    for (const auto& tp : tps) {
+      (*maker)(tp, tas);
+      reference(tp, reference_tas);
+    }
+    test::check_same_tas(tas, reference_tas);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_tas_as_reference)
+{
+  test::StreamConfig config;
+  config.n_channels = 150;
+  for (unsigned seed = 1; seed <= 4; ++seed) {
+    auto tps = test::make_tp_stream(seed, config);
+    for (uint16_t threshold : { 3, 5, 15 })
+      for (uint16_t tolerance : { 0, 3, 30 })
+        check_against_reference(tps, 400, threshold, tolerance);
+  }
+}
+
+// With a small threshold many short tracks are found in each window. The reference removed
+// each track's channels before looking again, which could in principle join up the TPs
+// either side of it.
+BOOST_AUTO_TEST_CASE(same_tas_as_reference_small_threshold)
+{
+  test::StreamConfig config;
+  config.n_channels = 60;
+  config.max_track_gap = 3;
+  for (unsigned seed = 10; seed <= 15; ++seed) {
+    auto tps = test::make_tp_stream(seed, config);
+    for (uint16_t threshold : { 0, 1, 2, 3 })
+      for (uint16_t tolerance : { 0, 1, 3, 30 })
+        check_against_reference(tps, 200, threshold, tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(same_tas_as_reference_with_prescale)
+{
+  auto tps = test::make_tp_stream(3);
+  check_against_reference(tps, 400, 3, 3, 3);
+}
+
+// Tracks laid out by hand: two tracks either side of a one-channel track, all in one window.
+BOOST_AUTO_TEST_CASE(adjacent_tracks_by_hand)
+{
+  std::vector<TriggerPrimitive> tps;
+  timestamp_t time = 100;
+  for (channel_t ch : { 10, 11, 12, 14, 15, 20, 26, 27, 28, 29, 31, 31, 32 })
+    tps.push_back(test::make_tp(time++, ch));
+  tps.push_back(test::make_tp(time + 1000, 100));
+  for (uint16_t threshold : { 0, 1, 2, 4 })
+    for (uint16_t tolerance : { 0, 1, 2, 10 })
+      check_against_reference(tps, 500, threshold, tolerance);
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,238 @@
+/**
+ * @file test_channel_distance.cxx
+ *
+ * Checks TriggerActivityMakerChannelDistance: the single TA mode against the original
+ * algorithm, and the multi-cluster mode against single TA makers run separately on
+ * well-separated channel groups.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_channel_distance
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// The original ChannelDistance TA maker, kept as the reference.
+class ReferenceChannelDistance
+{
+public:
+  ReferenceChannelDistance(uint32_t max_channel_distance, uint64_t window_length, uint16_t min_tps)
+    : m_max_channel_distance(max_channel_distance)
+    , m_window_length(window_length)
+    , m_min_tps(min_tps)
+  {}
+
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_tas)
+  {
+    if (m_current_ta.inputs.empty()) {
+      set_new_ta(input_tp);
+      return;
+    }
+
+    if (input_tp.time_start - m_current_ta.inputs.front().time_start > m_window_length) {
+      if (m_current_ta.inputs.size() >= m_min_tps) {
+        set_ta_attributes();
+        output_tas.push_back(m_current_ta);
+      }
+      set_new_ta(input_tp);
+      return;
+    }
+
+    if (input_tp.channel > m_current_upper_bound || input_tp.channel < m_current_lower_bound)
+      return;
+
+    m_current_ta.inputs.push_back(input_tp);
+    m_current_lower_bound = std::min(m_current_lower_bound, input_tp.channel - m_max_channel_distance);
+    m_current_upper_bound = std::max(m_current_upper_bound, input_tp.channel + m_max_channel_distance);
+  }
+
+private:
+  void set_new_ta(const TriggerPrimitive& input_tp)
+  {
+    m_current_ta = TriggerActivity();
+    m_current_ta.inputs.push_back(input_tp);
+    m_current_lower_bound = input_tp.channel - m_max_channel_distance;
+    m_current_upper_bound = input_tp.channel + m_max_channel_distance;
+  }
+
+  void set_ta_attributes()
+  {
+    TriggerPrimitive first_tp = m_current_ta.inputs.front();
+    TriggerPrimitive last_tp = m_current_ta.inputs.back();
+
+    m_current_ta.channel_start = first_tp.channel;
+    m_current_ta.channel_end = last_tp.channel;
+    m_current_ta.time_start = first_tp.time_start;
+    m_current_ta.time_end = last_tp.time_start;
+    m_current_ta.detid = first_tp.detid;
+    m_current_ta.algorithm = TriggerActivity::Algorithm::kChannelDistance;
+    m_current_ta.type = TriggerActivity::Type::kTPC;
+
+    m_current_ta.adc_peak = 0;
+    for (const TriggerPrimitive& tp : m_current_ta.inputs) {
+      m_current_ta.adc_integral += tp.adc_integral;
+      if (tp.adc_peak <= m_current_ta.adc_peak)
+        continue;
+      m_current_ta.adc_peak = tp.adc_peak;
+      m_current_ta.channel_peak = tp.channel;
+      m_current_ta.time_peak = tp.time_peak;
+    }
+    m_current_ta.time_activity = m_current_ta.time_peak;
+  }
+
+  TriggerActivity m_current_ta;
+  uint32_t m_max_channel_distance;
+  uint64_t m_window_length;
+  uint16_t m_min_tps;
+  uint32_t m_current_lower_bound = 0;
+  uint32_t m_current_upper_bound = 0;
+};
+
+std::unique_ptr<TriggerActivityMaker>
+make_maker(uint32_t max_channel_distance, uint64_t window_length, uint16_t min_tps, bool multi_cluster)
+{
+  auto maker = TriggerActivityFactory::get_instance()->build_maker("TriggerActivityMakerChannelDistancePlugin");
+  BOOST_REQUIRE(maker);
+  maker->configure({ { "max_channel_distance", max_channel_distance },
+                     { "window_length", window_length },
+                     { "min_tps", min_tps },
+                     { "multi_cluster", multi_cluster } });
+  return maker;
+}
+
+bool
+earlier(const TriggerActivity& a, const TriggerActivity& b)
+{
+  return std::make_tuple(a.time_start, a.channel_peak, a.inputs.size()) <
+         std::make_tuple(b.time_start, b.channel_peak, b.inputs.size());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(single_mode_same_tas_as_reference)
+{
+  test::StreamConfig config;
+  config.n_channels = 300;
+  for (unsigned seed = 1; seed <= 3; ++seed) {
+    auto tps = test::make_tp_stream(seed, config);
+    for (uint32_t distance : { 5, 20, 50 }) {
+      auto maker = make_maker(distance, 500, 4, false);
+      ReferenceChannelDistance reference(distance, 500, 4);
+      std::vector<TriggerActivity> tas, reference_tas;
+      for (const auto& tp : tps) {
+        (*maker)(tp, tas);
+        reference(tp, reference_tas);
+      }
+      BOOST_TEST(!tas.empty());
+      test::check_same_tas(tas, reference_tas);
+    }
+  }
+}
+
+// Activity on channel groups far further apart than max_channel_distance, each group narrower
+// than it: the multi-cluster maker must give what a single TA maker gives on each group alone.
+// The groups stay clear of channel 0, where the single TA mode's lower bound wraps around.
+BOOST_AUTO_TEST_CASE(multi_cluster_same_tas_as_separate_groups)
+{
+  const uint32_t distance = 20;
+  const uint64_t window_length = 400;
+  const uint16_t min_tps = 3;
+  const size_t n_groups = 5;
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<size_t> group(0, n_groups - 1);
+  std::uniform_int_distribution<channel_t> offset(0, distance - 1);
+  std::uniform_int_distribution<timestamp_t> spacing(0, 30);
+  std::vector<TriggerPrimitive> tps;
+  timestamp_t time = 1000;
+  for (size_t i = 0; i < 20000; ++i) {
+    time += spacing(rng);
+    tps.push_back(test::make_tp(time, (group(rng) + 1) * 1000 + offset(rng), 10 + i % 300));
+  }
+
+  auto multi = make_maker(distance, window_length, min_tps, true);
+  std::vector<TriggerActivity> multi_tas;
+  for (const auto& tp : tps)
+    (*multi)(tp, multi_tas);
+  multi->flush(std::numeric_limits<timestamp_t>::max(), multi_tas);
+
+  std::vector<TriggerActivity> group_tas;
+  for (size_t g = 0; g < n_groups; ++g) {
+    auto single = make_maker(distance, window_length, min_tps, false);
+    for (const auto& tp : tps)
+      if (tp.channel / 1000 == g + 1)
+        (*single)(tp, group_tas);
+    single->flush(std::numeric_limits<timestamp_t>::max(), group_tas);
+  }
+
+  // Only the channel range differs: the single TA mode takes it from the first and last TPs
+  // in time, the multi-cluster mode from the lowest and highest channels.
+  for (auto& ta : group_tas) {
+    auto range = std::minmax_element(
+      ta.inputs.begin(), ta.inputs.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) { return a.channel < b.channel; });
+    ta.channel_start = range.first->channel;
+    ta.channel_end = range.second->channel;
+  }
+  std::sort(multi_tas.begin(), multi_tas.end(), earlier);
+  std::sort(group_tas.begin(), group_tas.end(), earlier);
+  BOOST_TEST(multi_tas.size() > 100);
+  test::check_same_tas(multi_tas, group_tas);
+}
+
+// On a mixed stream every multi-cluster TA must be a time-ordered set of TPs no longer than the
+// window, spanning the channels it reports, and no TP may go into two TAs. The stream repeats
+// some (time_start, channel) pairs, so count them.
+BOOST_AUTO_TEST_CASE(multi_cluster_tas_are_consistent)
+{
+  test::StreamConfig config;
+  config.n_channels = 400;
+  auto tps = test::make_tp_stream(5, config);
+  auto maker = make_maker(10, 300, 3, true);
+  std::vector<TriggerActivity> tas;
+  for (const auto& tp : tps)
+    (*maker)(tp, tas);
+  maker->flush(std::numeric_limits<timestamp_t>::max(), tas);
+
+  std::map<std::pair<timestamp_t, channel_t>, size_t> unused;
+  for (const auto& tp : tps)
+    ++unused[{ tp.time_start, tp.channel }];
+
+  BOOST_TEST(!tas.empty());
+  for (const auto& ta : tas) {
+    BOOST_TEST(ta.inputs.size() >= 3u);
+    BOOST_TEST(std::is_sorted(ta.inputs.begin(), ta.inputs.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+      return a.time_start < b.time_start;
+    }));
+    BOOST_TEST(ta.inputs.back().time_start - ta.inputs.front().time_start <= 300u);
+    channel_t lowest = ta.inputs.front().channel, highest = ta.inputs.front().channel;
+    for (const auto& tp : ta.inputs) {
+      lowest = std::min(lowest, tp.channel);
+      highest = std::max(highest, tp.channel);
+      size_t& n_unused = unused[{ tp.time_start, tp.channel }];
+      BOOST_TEST(n_unused > 0u);
+      --n_unused;
+    }
+    BOOST_TEST(ta.channel_start == lowest);
+    BOOST_TEST(ta.channel_end == highest);
+  }
+}
+
+} // namespace triggeralgs
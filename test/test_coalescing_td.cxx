@@ -0,0 +1,192 @@
+/**
+ * @file test_coalescing_td.cxx
+ *
+ * Checks TriggerDecisionMakerCoalescing against a reference that keeps its pending decisions
+ * in a plain list and searches all of them for each candidate.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_coalescing_td
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerDecisionFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+class ReferenceCoalescing
+{
+public:
+  ReferenceCoalescing(timestamp_t latency, timestamp_t merge_gap)
+    : m_latency(latency)
+    , m_merge_gap(merge_gap)
+  {}
+
+  void operator()(const TriggerCandidate& tc, std::vector<TriggerDecision>& tds)
+  {
+    release(tc.time_candidate, tds);
+
+    // Every pending decision within merge_gap of the candidate's window, earliest first.
+    std::vector<size_t> overlapping;
+    for (size_t i = 0; i < m_pending.size(); ++i)
+      if (m_pending[i].td.time_end + m_merge_gap >= tc.time_start && m_pending[i].td.time_start <= tc.time_end + m_merge_gap)
+        overlapping.push_back(i);
+    std::sort(overlapping.begin(), overlapping.end(), [this](size_t a, size_t b) {
+      return m_pending[a].td.time_start < m_pending[b].td.time_start;
+    });
+
+    if (overlapping.empty()) {
+      Pending pending;
+      pending.opened = m_data_time;
+      pending.td.time_start = tc.time_start;
+      pending.td.time_end = tc.time_end;
+      pending.td.time_trigger = tc.time_candidate;
+      pending.td.type = static_cast<uint32_t>(tc.type);           // NOLINT(build/unsigned)
+      pending.td.algorithm = static_cast<uint32_t>(tc.algorithm); // NOLINT(build/unsigned)
+      pending.td.version = tc.version;
+      pending.td.tc_list.push_back(tc);
+      m_pending.push_back(pending);
+      return;
+    }
+
+    Pending merged = m_pending[overlapping.front()];
+    for (size_t k = 1; k < overlapping.size(); ++k) {
+      const Pending& other = m_pending[overlapping[k]];
+      merged.opened = std::min(merged.opened, other.opened);
+      merged.td.time_end = std::max(merged.td.time_end, other.td.time_end);
+      merged.td.time_trigger = std::min(merged.td.time_trigger, other.td.time_trigger);
+      merged.td.tc_list.insert(merged.td.tc_list.end(), other.td.tc_list.begin(), other.td.tc_list.end());
+    }
+    merged.td.time_start = std::min(merged.td.time_start, tc.time_start);
+    merged.td.time_end = std::max(merged.td.time_end, tc.time_end);
+    merged.td.time_trigger = std::min(merged.td.time_trigger, tc.time_candidate);
+    merged.td.tc_list.push_back(tc);
+
+    std::sort(overlapping.rbegin(), overlapping.rend());
+    for (size_t i : overlapping)
+      m_pending.erase(m_pending.begin() + i);
+    m_pending.push_back(merged);
+  }
+
+  void release(timestamp_t now, std::vector<TriggerDecision>& tds)
+  {
+    m_data_time = std::max(m_data_time, now);
+    while (true) {
+      auto oldest = std::min_element(m_pending.begin(), m_pending.end(), [](const Pending& a, const Pending& b) {
+        return std::make_tuple(a.opened, a.td.time_start) < std::make_tuple(b.opened, b.td.time_start);
+      });
+      if (oldest == m_pending.end() || m_data_time - oldest->opened < m_latency)
+        return;
+      oldest->td.trigger_number = m_trigger_number++;
+      tds.push_back(oldest->td);
+      m_pending.erase(oldest);
+    }
+  }
+
+private:
+  struct Pending
+  {
+    timestamp_t opened;
+    TriggerDecision td;
+  };
+
+  std::vector<Pending> m_pending;
+  timestamp_t m_latency;
+  timestamp_t m_merge_gap;
+  timestamp_t m_data_time = 0;
+  trigger_number_t m_trigger_number = 0;
+};
+
+// Candidates in time_candidate order, a few ticks out of order now and then, with readout
+// windows of varying length around time_candidate.
+std::vector<TriggerCandidate>
+make_tc_stream(unsigned seed, size_t n_tcs)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<timestamp_t> spacing(0, 3000);
+  std::uniform_int_distribution<timestamp_t> before(0, 2000);
+  std::uniform_int_distribution<timestamp_t> after(0, 4000);
+  std::uniform_int_distribution<int> late(0, 9);
+  std::vector<TriggerCandidate> tcs;
+  timestamp_t time = 100'000;
+  for (size_t i = 0; i < n_tcs; ++i) {
+    time += spacing(rng);
+    TriggerCandidate tc;
+    tc.time_candidate = late(rng) == 0 ? time - 500 : time;
+    tc.time_start = tc.time_candidate - before(rng);
+    tc.time_end = tc.time_candidate + after(rng);
+    tc.type = TriggerCandidate::Type::kTiming;
+    tc.algorithm = TriggerCandidate::Algorithm::kPrescale;
+    tcs.push_back(tc);
+  }
+  return tcs;
+}
+
+void
+check_same_td(const TriggerDecision& a, const TriggerDecision& b)
+{
+  BOOST_TEST(a.time_start == b.time_start);
+  BOOST_TEST(a.time_end == b.time_end);
+  BOOST_TEST(a.time_trigger == b.time_trigger);
+  BOOST_TEST(a.trigger_number == b.trigger_number);
+  BOOST_TEST(a.type == b.type);
+  BOOST_TEST(a.algorithm == b.algorithm);
+  BOOST_REQUIRE_EQUAL(a.tc_list.size(), b.tc_list.size());
+  for (size_t i = 0; i < a.tc_list.size(); ++i)
+    test::check_same_tc(a.tc_list[i], b.tc_list[i]);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_tds_as_reference)
+{
+  for (unsigned seed = 1; seed <= 3; ++seed) {
+    auto tcs = make_tc_stream(seed, 5000);
+    for (timestamp_t latency : { 0, 1000, 20000 })
+      for (timestamp_t merge_gap : { 0, 200, 3000 }) {
+        BOOST_TEST_CONTEXT("seed " << seed << ", latency " << latency << ", merge_gap " << merge_gap)
+        {
+          auto maker = TriggerDecisionFactory::get_instance()->build_maker("TriggerDecisionMakerCoalescingPlugin");
+          BOOST_REQUIRE(maker);
+          maker->configure({ { "latency", latency }, { "merge_gap", merge_gap } });
+          ReferenceCoalescing reference(latency, merge_gap);
+
+          std::vector<TriggerDecision> tds, reference_tds;
+          for (const auto& tc : tcs) {
+            (*maker)(tc, tds);
+            reference(tc, reference_tds);
+          }
+          maker->flush(std::numeric_limits<timestamp_t>::max(), tds);
+          reference.release(std::numeric_limits<timestamp_t>::max(), reference_tds);
+
+          // Every candidate ends up in exactly one decision.
+          size_t n_tcs = 0;
+          for (const auto& td : tds)
+            n_tcs += td.tc_list.size();
+          BOOST_TEST(n_tcs == tcs.size());
+          if (latency > 0)
+            BOOST_TEST(tds.size() < tcs.size());
+
+          BOOST_REQUIRE_EQUAL(tds.size(), reference_tds.size());
+          for (size_t i = 0; i < tds.size(); ++i)
+            check_same_td(tds[i], reference_tds[i]);
+        }
+      }
+  }
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,141 @@
+/**
+ * @file test_composite.cxx
+ *
+ * Checks TriggerActivityMakerComposite against HorizontalMuon, which checks the same three
+ * conditions in the same order on its own window, and shows how it differs from running one
+ * maker per condition side by side.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_composite
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+const timestamp_t s_window_length = 400;
+const uint64_t s_adc_threshold = 14000;
+const uint16_t s_n_channels_threshold = 40;
+const uint16_t s_adjacency_threshold = 8;
+
+std::vector<TriggerActivity>
+run(const std::string& name, const nlohmann::json& config, const std::vector<TriggerPrimitive>& tps)
+{
+  auto maker = TriggerActivityFactory::get_instance()->build_maker(name);
+  BOOST_REQUIRE(maker);
+  maker->configure(config);
+  std::vector<TriggerActivity> tas;
+  for (const auto& tp : tps)
+    (*maker)(tp, tas);
+  maker->flush(std::numeric_limits<timestamp_t>::max(), tas);
+  return tas;
+}
+
+std::vector<TriggerActivity>
+run_composite(bool on_adc, bool on_n_channels, bool on_adjacency, const std::vector<TriggerPrimitive>& tps)
+{
+  nlohmann::json conditions = nlohmann::json::array();
+  if (on_adc)
+    conditions.push_back({ { "type", "adc" }, { "threshold", s_adc_threshold } });
+  if (on_n_channels)
+    conditions.push_back({ { "type", "n_channels" }, { "threshold", s_n_channels_threshold } });
+  if (on_adjacency)
+    conditions.push_back({ { "type", "adjacency" }, { "threshold", s_adjacency_threshold }, { "tolerance", 3 } });
+  return run("TriggerActivityMakerCompositePlugin", { { "window_length", s_window_length }, { "conditions", conditions } }, tps);
+}
+
+std::vector<TriggerActivity>
+run_horizontal_muon(bool on_adc, bool on_n_channels, bool on_adjacency, const std::vector<TriggerPrimitive>& tps)
+{
+  return run("TriggerActivityMakerHorizontalMuonPlugin",
+             { { "window_length", s_window_length },
+               { "trigger_on_adc", on_adc },
+               { "adc_threshold", s_adc_threshold },
+               { "trigger_on_n_channels", on_n_channels },
+               { "n_channels_threshold", s_n_channels_threshold },
+               { "trigger_on_adjacency", on_adjacency },
+               { "adjacency_threshold", s_adjacency_threshold },
+               { "adj_tolerance", 3 } },
+             tps);
+}
+
+// The windows must match. HorizontalMuon takes adc_peak from the last TP's ADC integral and
+// always records kHorizontalMuon, so the peak fields and algorithm are not compared.
+void
+check_same_windows(const std::vector<TriggerActivity>& tas, const std::vector<TriggerActivity>& expected)
+{
+  BOOST_REQUIRE_EQUAL(tas.size(), expected.size());
+  for (size_t i = 0; i < tas.size(); ++i) {
+    BOOST_TEST_CONTEXT("TA " << i)
+    {
+      BOOST_TEST(tas[i].time_start == expected[i].time_start);
+      BOOST_TEST(tas[i].time_end == expected[i].time_end);
+      BOOST_TEST(tas[i].channel_start == expected[i].channel_start);
+      BOOST_TEST(tas[i].channel_end == expected[i].channel_end);
+      BOOST_TEST(tas[i].adc_integral == expected[i].adc_integral);
+      BOOST_TEST(tas[i].detid == expected[i].detid);
+      BOOST_REQUIRE_EQUAL(tas[i].inputs.size(), expected[i].inputs.size());
+      for (size_t j = 0; j < tas[i].inputs.size(); ++j)
+        test::check_same_tp(tas[i].inputs[j], expected[i].inputs[j]);
+    }
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(one_condition_same_windows_as_horizontal_muon)
+{
+  auto tps = test::make_tp_stream(1);
+  for (int condition = 0; condition < 3; ++condition) {
+    BOOST_TEST_CONTEXT("condition " << condition)
+    {
+      auto expected = run_horizontal_muon(condition == 0, condition == 1, condition == 2, tps);
+      BOOST_TEST(!expected.empty());
+      check_same_windows(run_composite(condition == 0, condition == 1, condition == 2, tps), expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(all_conditions_same_windows_as_horizontal_muon)
+{
+  for (unsigned seed = 2; seed <= 4; ++seed) {
+    auto tps = test::make_tp_stream(seed);
+    auto expected = run_horizontal_muon(true, true, true, tps);
+    BOOST_TEST(!expected.empty());
+    auto tas = run_composite(true, true, true, tps);
+    check_same_windows(tas, expected);
+
+    // The algorithm records the first condition that fired.
+    for (const auto& ta : tas)
+      BOOST_TEST((ta.algorithm == TriggerActivity::Algorithm::kADCSimpleWindow) == (ta.adc_integral > s_adc_threshold));
+  }
+}
+
+// One maker per condition each keep their own window, so both can make a TA from the same
+// TPs. The composite makes one TA per window, so it makes fewer than the makers together.
+BOOST_AUTO_TEST_CASE(not_the_same_as_makers_side_by_side)
+{
+  auto tps = test::make_tp_stream(5);
+  size_t n_adc = run_horizontal_muon(true, false, false, tps).size();
+  size_t n_adjacency = run_horizontal_muon(false, false, true, tps).size();
+  size_t n_composite = run_composite(true, false, true, tps).size();
+  BOOST_TEST(n_adc > 0u);
+  BOOST_TEST(n_adjacency > 0u);
+  BOOST_TEST(n_composite < n_adc + n_adjacency);
+}
+
+} // namespace triggeralgs
@@ -9,8 +9,8 @@
 // NOLINTNEXTLINE(build/define_used)
 #define BOOST_TEST_MODULE boost_test_macro_overview
 
-#include "triggeralgs/TriggerActivityFactory.hpp"
-#include "triggeralgs/TriggerActivityMaker.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityMaker.hpp"
 
 #include <boost/test/included/unit_test.hpp>
 
@@ -23,7 +23,7 @@ namespace triggeralgs {
 
 BOOST_AUTO_TEST_CASE(test_macro_overview)
 {
-  std::unique_ptr<TriggerActivityMaker> prescale_maker = TriggerActivityFactory::makeTAMaker("TriggerActivityMakerPrescalePlugin");
+  std::unique_ptr<TriggerActivityMaker> prescale_maker = TriggerActivityFactory::get_instance()->build_maker("TriggerActivityMakerPrescalePlugin");
 
   std::vector<TriggerActivity> prescale_ta;
   TriggerPrimitive some_tp;
@@ -0,0 +1,281 @@
+/**
+ * @file test_flush.cxx
+ *
+ * Checks the flush(until) contract of every maker that implements it: flushing whenever no
+ * earlier input can arrive any more changes when outputs come out, but not what they are.
+ * Also checks that FlushScheduler keeps to its interval up to the end of the stream.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_flush
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/FlushScheduler.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateFactory.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerDecisionFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+const timestamp_t s_end_of_stream = std::numeric_limits<timestamp_t>::max();
+
+// Flush intervals in ticks of data time: 1 flushes before every input.
+const std::vector<timestamp_t> s_flush_intervals = { 1, 100, 5000 };
+
+std::unique_ptr<TriggerActivityMaker>
+make_ta_maker(const std::string& name, const nlohmann::json& config)
+{
+  auto maker = TriggerActivityFactory::get_instance()->build_maker(name);
+  BOOST_REQUIRE(maker);
+  maker->configure(config);
+  return maker;
+}
+
+std::unique_ptr<TriggerCandidateMaker>
+make_tc_maker(const std::string& name, const nlohmann::json& config)
+{
+  auto maker = TriggerCandidateFactory::get_instance()->build_maker(name);
+  BOOST_REQUIRE(maker);
+  maker->configure(config);
+  return maker;
+}
+
+// Runs `inputs` through `maker`. With a non-zero `flush_interval`, also flushes up to the
+// next input's time whenever that is at least flush_interval ticks past the last flush.
+template<typename Maker, typename Input, typename Output>
+std::vector<Output>
+run(Maker& maker, const std::vector<Input>& inputs, timestamp_t (*time_of)(const Input&), timestamp_t flush_interval)
+{
+  std::vector<Output> outputs;
+  timestamp_t next_flush = 0;
+  for (const auto& input : inputs) {
+    if (flush_interval > 0 && time_of(input) >= next_flush) {
+      maker.flush(time_of(input), outputs);
+      next_flush = time_of(input) + flush_interval;
+    }
+    maker(input, outputs);
+  }
+  maker.flush(s_end_of_stream, outputs);
+  return outputs;
+}
+
+timestamp_t
+tp_time(const TriggerPrimitive& tp)
+{
+  return tp.time_start;
+}
+
+timestamp_t
+ta_time(const TriggerActivity& ta)
+{
+  return ta.time_start;
+}
+
+timestamp_t
+tc_time(const TriggerCandidate& tc)
+{
+  return tc.time_candidate;
+}
+
+void
+check_ta_maker(const std::string& name, const nlohmann::json& config, const std::vector<TriggerPrimitive>& tps)
+{
+  auto plain = make_ta_maker(name, config);
+  auto expected = run<TriggerActivityMaker, TriggerPrimitive, TriggerActivity>(*plain, tps, tp_time, 0);
+  BOOST_TEST(!expected.empty());
+  for (timestamp_t interval : s_flush_intervals) {
+    BOOST_TEST_CONTEXT(name << ", flushing every " << interval << " ticks")
+    {
+      auto flushed = make_ta_maker(name, config);
+      test::check_same_tas(run<TriggerActivityMaker, TriggerPrimitive, TriggerActivity>(*flushed, tps, tp_time, interval),
+                           expected);
+    }
+  }
+}
+
+void
+check_tc_maker(const std::string& name, const nlohmann::json& config, const std::vector<TriggerActivity>& tas)
+{
+  auto plain = make_tc_maker(name, config);
+  auto expected = run<TriggerCandidateMaker, TriggerActivity, TriggerCandidate>(*plain, tas, ta_time, 0);
+  BOOST_TEST(!expected.empty());
+  for (timestamp_t interval : s_flush_intervals) {
+    BOOST_TEST_CONTEXT(name << ", flushing every " << interval << " ticks")
+    {
+      auto flushed = make_tc_maker(name, config);
+      test::check_same_tcs(run<TriggerCandidateMaker, TriggerActivity, TriggerCandidate>(*flushed, tas, ta_time, interval),
+                           expected);
+    }
+  }
+}
+
+// TAs in time_start order, as a TC maker expects them.
+std::vector<TriggerActivity>
+make_tas(const std::string& name, const nlohmann::json& config, const std::vector<TriggerPrimitive>& tps)
+{
+  auto maker = make_ta_maker(name, config);
+  auto tas = run<TriggerActivityMaker, TriggerPrimitive, TriggerActivity>(*maker, tps, tp_time, 0);
+  std::stable_sort(tas.begin(), tas.end(), [](const TriggerActivity& a, const TriggerActivity& b) {
+    return a.time_start < b.time_start;
+  });
+  return tas;
+}
+
+// Counts the flushes the scheduler makes.
+class FlushCounter : public TriggerActivityMaker
+{
+public:
+  using TriggerActivityMaker::flush;
+  void operator()(const TriggerPrimitive&, std::vector<TriggerActivity>&) override {}
+  void flush(timestamp_t, std::vector<TriggerActivity>&) override { ++n_flushes; }
+  size_t n_flushes = 0;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(adc_simple_window)
+{
+  check_ta_maker("TriggerActivityMakerADCSimpleWindowPlugin",
+                 { { "window_length", 500 }, { "adc_threshold", 12000 } },
+                 test::make_tp_stream(1));
+}
+
+BOOST_AUTO_TEST_CASE(channel_distance)
+{
+  for (bool multi_cluster : { false, true })
+    check_ta_maker("TriggerActivityMakerChannelDistancePlugin",
+                   { { "max_channel_distance", 10 }, { "window_length", 300 }, { "min_tps", 3 }, { "multi_cluster", multi_cluster } },
+                   test::make_tp_stream(2));
+}
+
+BOOST_AUTO_TEST_CASE(channel_adjacency)
+{
+  check_ta_maker("TriggerActivityMakerChannelAdjacencyPlugin",
+                 { { "window_length", 400 }, { "adjacency_threshold", 5 }, { "adj_tolerance", 3 } },
+                 test::make_tp_stream(3));
+}
+
+BOOST_AUTO_TEST_CASE(horizontal_muon)
+{
+  check_ta_maker("TriggerActivityMakerHorizontalMuonPlugin",
+                 { { "window_length", 400 },
+                   { "trigger_on_adc", true },
+                   { "adc_threshold", 14000 },
+                   { "trigger_on_n_channels", true },
+                   { "n_channels_threshold", 40 },
+                   { "adjacency_threshold", 8 } },
+                 test::make_tp_stream(4));
+}
+
+BOOST_AUTO_TEST_CASE(michel_electron)
+{
+  // The maker wants long tracks with a Bragg peak and a kink, so make the runs long. It only
+  // fires a few times on any stream: a window whose track fails those checks stops sliding.
+  test::StreamConfig config;
+  config.track_fraction = 0.5;
+  config.max_track_length = 80;
+  config.max_track_gap = 3;
+  check_ta_maker("TriggerActivityMakerMichelElectronPlugin",
+                 { { "window_length", 500 }, { "adjacency_threshold", 25 }, { "adj_tolerance", 3 } },
+                 test::make_tp_stream(5, config));
+}
+
+BOOST_AUTO_TEST_CASE(plane_coincidence)
+{
+  check_ta_maker("TriggerActivityMakerPlaneCoincidencePlugin",
+                 { { "window_length", 400 }, { "adc_threshold", 14000 }, { "n_channels_threshold", 40 }, { "adjacency_threshold", 8 } },
+                 test::make_tp_stream(6));
+}
+
+BOOST_AUTO_TEST_CASE(dbscan)
+{
+  check_ta_maker("TriggerActivityMakerDBSCANPlugin", { { "eps", 20 }, { "min_pts", 4 } }, test::make_tp_stream(7));
+}
+
+BOOST_AUTO_TEST_CASE(supernova_activity)
+{
+  check_ta_maker("TriggerActivityMakerSupernovaPlugin", nlohmann::json::object(), test::make_tp_stream(8));
+}
+
+BOOST_AUTO_TEST_CASE(michel_electron_candidate)
+{
+  auto tas = make_tas("TriggerActivityMakerHorizontalMuonPlugin",
+                      { { "window_length", 400 }, { "trigger_on_adc", true }, { "adc_threshold", 14000 } },
+                      test::make_tp_stream(9));
+  check_tc_maker("TriggerCandidateMakerMichelElectronPlugin", nlohmann::json::object(), tas);
+}
+
+BOOST_AUTO_TEST_CASE(plane_coincidence_candidate)
+{
+  auto tas = make_tas("TriggerActivityMakerHorizontalMuonPlugin",
+                      { { "window_length", 400 }, { "trigger_on_adc", true }, { "adc_threshold", 14000 } },
+                      test::make_tp_stream(10));
+  check_tc_maker("TriggerCandidateMakerPlaneCoincidencePlugin", nlohmann::json::object(), tas);
+}
+
+BOOST_AUTO_TEST_CASE(coalescing_decision)
+{
+  auto tas = make_tas("TriggerActivityMakerHorizontalMuonPlugin",
+                      { { "window_length", 400 }, { "trigger_on_adc", true }, { "adc_threshold", 14000 } },
+                      test::make_tp_stream(11));
+  std::vector<TriggerCandidate> tcs;
+  auto tc_maker = make_tc_maker("TriggerCandidateMakerPrescalePlugin", { { "prescale", 1 } });
+  for (const auto& ta : tas)
+    (*tc_maker)(ta, tcs);
+
+  const nlohmann::json config = { { "latency", 2000 }, { "merge_gap", 100 } };
+  auto plain = TriggerDecisionFactory::get_instance()->build_maker("TriggerDecisionMakerCoalescingPlugin");
+  plain->configure(config);
+  auto expected = run<TriggerDecisionMaker, TriggerCandidate, TriggerDecision>(*plain, tcs, tc_time, 0);
+  BOOST_TEST(!expected.empty());
+  for (timestamp_t interval : s_flush_intervals) {
+    BOOST_TEST_CONTEXT("flushing every " << interval << " ticks")
+    {
+      auto flushed = TriggerDecisionFactory::get_instance()->build_maker("TriggerDecisionMakerCoalescingPlugin");
+      flushed->configure(config);
+      auto tds = run<TriggerDecisionMaker, TriggerCandidate, TriggerDecision>(*flushed, tcs, tc_time, interval);
+      BOOST_REQUIRE_EQUAL(tds.size(), expected.size());
+      for (size_t i = 0; i < tds.size(); ++i) {
+        BOOST_TEST(tds[i].time_start == expected[i].time_start);
+        BOOST_TEST(tds[i].time_end == expected[i].time_end);
+        BOOST_TEST(tds[i].tc_list.size() == expected[i].tc_list.size());
+      }
+    }
+  }
+}
+
+// Near the end of the timestamp range the next flush time must saturate rather than wrap round.
+BOOST_AUTO_TEST_CASE(scheduler_interval_at_end_of_stream)
+{
+  FlushCounter ta_maker;
+  auto tc_maker = make_tc_maker("TriggerCandidateMakerPrescalePlugin", { { "prescale", 1 } });
+  FlushScheduler scheduler(ta_maker, *tc_maker);
+  scheduler.configure({ { "flush_interval", 100 } });
+
+  std::vector<TriggerActivity> tas;
+  std::vector<TriggerCandidate> tcs;
+  scheduler.heartbeat(1000, tas, tcs);
+  scheduler.heartbeat(1050, tas, tcs);
+  BOOST_TEST(ta_maker.n_flushes == 1u);
+  scheduler.heartbeat(s_end_of_stream - 50, tas, tcs);
+  BOOST_TEST(ta_maker.n_flushes == 2u);
+  scheduler.heartbeat(s_end_of_stream - 10, tas, tcs);
+  BOOST_TEST(ta_maker.n_flushes == 2u);
+  scheduler.heartbeat(s_end_of_stream, tas, tcs);
+  BOOST_TEST(ta_maker.n_flushes == 3u);
+}
+
+} // namespace triggeralgs
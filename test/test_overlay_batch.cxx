@@ -0,0 +1,143 @@
+/**
+ * @file test_overlay_batch.cxx
+ *
+ * Checks that a batch of overlays reads back as the objects it was written from, and that a
+ * batch that is cut short or whose offset table or input counts are corrupt is invalid.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_overlay_batch
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerObjectOverlay.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+using ActivityOverlay = TypeToOverlayType<TriggerActivity>::overlay_t;
+
+// TAs with 0, 1, 2, ... TPs each, so the overlays have different sizes.
+std::vector<TriggerActivity>
+make_tas(size_t n_tas)
+{
+  auto tps = test::make_tp_stream(1);
+  std::vector<TriggerActivity> tas(n_tas);
+  size_t next = 0;
+  for (size_t i = 0; i < n_tas; ++i) {
+    TriggerActivity& ta = tas[i];
+    ta.time_start = tps[next].time_start;
+    ta.channel_start = tps[next].channel;
+    ta.adc_integral = i;
+    for (size_t j = 0; j < i; ++j)
+      ta.inputs.push_back(tps[next++]);
+    ta.time_end = tps[next].time_start;
+  }
+  return tas;
+}
+
+// Offset of overlay `i` in a batch, from its offset table.
+uint64_t&
+offset_of(std::vector<uint64_t>& batch, size_t i)
+{
+  return batch[1 + i];
+}
+
+ActivityOverlay&
+overlay_at(std::vector<uint64_t>& batch, size_t i)
+{
+  return *reinterpret_cast<ActivityOverlay*>(reinterpret_cast<char*>(batch.data()) + offset_of(batch, i));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+  auto tas = make_tas(6);
+  auto batch = write_overlay_batch(tas);
+  OverlayBatchView<TriggerActivity> view(batch.data(), get_overlay_batch_nbytes(tas));
+  BOOST_REQUIRE(view.is_valid());
+  BOOST_REQUIRE_EQUAL(view.size(), tas.size());
+
+  size_t i = 0;
+  for (const ActivityView& ta : view) {
+    BOOST_TEST_CONTEXT("TA " << i)
+    {
+      BOOST_REQUIRE(ta.is_valid());
+      test::check_same_ta(ta.materialize(), tas[i]);
+    }
+    ++i;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(empty_batch)
+{
+  std::vector<TriggerActivity> tas;
+  auto batch = write_overlay_batch(tas);
+  OverlayBatchView<TriggerActivity> view(batch.data(), get_overlay_batch_nbytes(tas));
+  BOOST_TEST(view.is_valid());
+  BOOST_TEST(view.empty());
+}
+
+// Every cut short of the full size loses part of the table or of an overlay.
+BOOST_AUTO_TEST_CASE(truncated_batch_invalid)
+{
+  auto tas = make_tas(4);
+  auto batch = write_overlay_batch(tas);
+  size_t nbytes = get_overlay_batch_nbytes(tas);
+  for (size_t cut = 0; cut < nbytes; ++cut) {
+    OverlayBatchView<TriggerActivity> view(batch.data(), cut);
+    BOOST_TEST_CONTEXT("cut to " << cut << " of " << nbytes << " bytes")
+    {
+      BOOST_TEST(!view.is_valid());
+      BOOST_TEST(view.empty());
+    }
+  }
+  BOOST_TEST(OverlayBatchView<TriggerActivity>(nullptr, nbytes).is_valid() == false);
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_batch_invalid)
+{
+  auto tas = make_tas(4);
+  const auto good = write_overlay_batch(tas);
+  const size_t nbytes = get_overlay_batch_nbytes(tas);
+  auto is_valid = [&](std::vector<uint64_t> batch) {
+    return OverlayBatchView<TriggerActivity>(batch.data(), nbytes).is_valid();
+  };
+  BOOST_REQUIRE(is_valid(good));
+
+  auto batch = good;
+  batch[0] = nbytes; // More objects than the table has room for
+  BOOST_TEST(!is_valid(batch));
+
+  batch = good;
+  offset_of(batch, 2) = nbytes + 8; // Past the end
+  BOOST_TEST(!is_valid(batch));
+
+  batch = good;
+  offset_of(batch, 1) = 8; // Inside the table
+  BOOST_TEST(!is_valid(batch));
+
+  batch = good;
+  offset_of(batch, 3) += 1; // Misaligned
+  BOOST_TEST(!is_valid(batch));
+
+  batch = good;
+  overlay_at(batch, 3).n_inputs += 1; // More inputs than are left in the buffer
+  BOOST_TEST(!is_valid(batch));
+
+  batch = good;
+  overlay_at(batch, 0).n_inputs = ~uint64_t(0);
+  BOOST_TEST(!is_valid(batch));
+}
+
+} // namespace triggeralgs
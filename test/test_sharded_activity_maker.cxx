@@ -0,0 +1,157 @@
+/**
+ * @file test_sharded_activity_maker.cxx
+ *
+ * Checks that ShardedActivityMaker gives the TAs one maker per detector unit would, in the
+ * same order, and that it can't deadlock when its rings fill up.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_sharded_activity_maker
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+const nlohmann::json s_channel_distance_config = { { "max_channel_distance", 10 },
+                                                   { "window_length", 300 },
+                                                   { "min_tps", 3 } };
+
+std::unique_ptr<TriggerActivityMaker>
+make_sharded(const std::string& maker, const nlohmann::json& maker_config, size_t n_shards, size_t ring_capacity)
+{
+  auto sharded = TriggerActivityFactory::get_instance()->build_maker("ShardedActivityMakerPlugin");
+  BOOST_REQUIRE(sharded);
+  sharded->configure({ { "maker", maker },
+                       { "maker_config", maker_config },
+                       { "n_shards", n_shards },
+                       { "ring_capacity", ring_capacity } });
+  return sharded;
+}
+
+std::vector<TriggerActivity>
+run(TriggerActivityMaker& maker, const std::vector<TriggerPrimitive>& tps)
+{
+  std::vector<TriggerActivity> tas;
+  for (const auto& tp : tps)
+    maker(tp, tas);
+  maker.flush(std::numeric_limits<timestamp_t>::max(), tas);
+  return tas;
+}
+
+// One maker per detid, each given only its own TPs.
+std::vector<std::vector<TriggerActivity>>
+run_per_detid(const std::string& maker_name,
+              const nlohmann::json& maker_config,
+              const std::vector<TriggerPrimitive>& tps,
+              uint16_t n_detids)
+{
+  std::vector<std::vector<TriggerActivity>> tas(n_detids);
+  for (uint16_t detid = 0; detid < n_detids; ++detid) {
+    auto maker = TriggerActivityFactory::get_instance()->build_maker(maker_name);
+    maker->configure(maker_config);
+    std::vector<TriggerPrimitive> unit_tps;
+    for (const auto& tp : tps)
+      if (tp.detid == detid)
+        unit_tps.push_back(tp);
+    tas[detid] = run(*maker, unit_tps);
+  }
+  return tas;
+}
+
+// The sharded output, split by detid, must be what each unit's own maker gives.
+void
+check_per_detid(const std::vector<TriggerActivity>& tas, const std::vector<std::vector<TriggerActivity>>& expected)
+{
+  std::vector<std::vector<TriggerActivity>> split(expected.size());
+  for (const auto& ta : tas) {
+    BOOST_REQUIRE(ta.detid < expected.size());
+    split[ta.detid].push_back(ta);
+  }
+  for (size_t detid = 0; detid < expected.size(); ++detid) {
+    BOOST_TEST_CONTEXT("detid " << detid)
+    {
+      BOOST_TEST(!expected[detid].empty());
+      test::check_same_tas(split[detid], expected[detid]);
+    }
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(one_shard_same_tas_as_one_maker)
+{
+  auto tps = test::make_tp_stream(1);
+  auto maker = TriggerActivityFactory::get_instance()->build_maker("TriggerActivityMakerChannelDistancePlugin");
+  maker->configure(s_channel_distance_config);
+  auto sharded = make_sharded("TriggerActivityMakerChannelDistancePlugin", s_channel_distance_config, 1, 64);
+  auto tas = run(*maker, tps);
+  BOOST_TEST(!tas.empty());
+  test::check_same_tas(run(*sharded, tps), tas);
+}
+
+BOOST_AUTO_TEST_CASE(shards_same_tas_as_one_maker_per_unit)
+{
+  test::StreamConfig config;
+  config.n_detids = 4;
+  auto tps = test::make_tp_stream(2, config);
+  auto expected = run_per_detid("TriggerActivityMakerChannelDistancePlugin", s_channel_distance_config, tps, 4);
+  auto sharded = make_sharded("TriggerActivityMakerChannelDistancePlugin", s_channel_distance_config, 4, 64);
+  check_per_detid(run(*sharded, tps), expected);
+}
+
+// The Prescale maker makes a TA per TP, so with rings of two slots both the input and the
+// output rings are full most of the time. Each TA is tagged with its own TP's time, so the
+// merged output must also be in time order.
+BOOST_AUTO_TEST_CASE(full_rings_dont_deadlock)
+{
+  test::StreamConfig config;
+  config.n_detids = 3;
+  auto tps = test::make_tp_stream(3, config);
+  const nlohmann::json prescale_config = { { "prescale", 1 } };
+  auto expected = run_per_detid("TriggerActivityMakerPrescalePlugin", prescale_config, tps, 3);
+  auto sharded = make_sharded("TriggerActivityMakerPrescalePlugin", prescale_config, 3, 2);
+  auto tas = run(*sharded, tps);
+  BOOST_TEST(tas.size() == tps.size());
+  check_per_detid(tas, expected);
+  BOOST_TEST(std::is_sorted(tas.begin(), tas.end(), [](const TriggerActivity& a, const TriggerActivity& b) {
+    return a.time_start < b.time_start;
+  }));
+}
+
+// Workers left idle long enough to park must still pick up the next TP.
+BOOST_AUTO_TEST_CASE(parked_workers_wake_up)
+{
+  test::StreamConfig config;
+  config.n_tps = 200;
+  config.n_detids = 2;
+  auto tps = test::make_tp_stream(4, config);
+  const nlohmann::json prescale_config = { { "prescale", 1 } };
+  auto sharded = make_sharded("TriggerActivityMakerPrescalePlugin", prescale_config, 2, 4);
+
+  std::vector<TriggerActivity> tas;
+  for (size_t i = 0; i < tps.size(); ++i) {
+    (*sharded)(tps[i], tas);
+    if (i % 20 == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  sharded->flush(std::numeric_limits<timestamp_t>::max(), tas);
+  BOOST_TEST(tas.size() == tps.size());
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,72 @@
+/**
+ * @file test_spsc_ring.cxx
+ *
+ * Checks that SPSCRing hands items from one thread to another in order, without loss, when
+ * it is full or empty most of the time.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_spsc_ring
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/SPSCRing.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+namespace triggeralgs {
+
+BOOST_AUTO_TEST_CASE(capacity_rounded_up)
+{
+  BOOST_TEST(SPSCRing<int>(0).capacity() == 2u);
+  BOOST_TEST(SPSCRing<int>(3).capacity() == 4u);
+  BOOST_TEST(SPSCRing<int>(64).capacity() == 64u);
+}
+
+BOOST_AUTO_TEST_CASE(full_and_empty)
+{
+  SPSCRing<int> ring(4);
+  int item = 0;
+  BOOST_TEST(!ring.try_pop(item));
+  for (int i = 0; i < 4; ++i)
+    BOOST_TEST(ring.try_push(i));
+  BOOST_TEST(!ring.try_push(4));
+  BOOST_TEST(ring.size() == 4u);
+  for (int i = 0; i < 4; ++i) {
+    BOOST_TEST(ring.try_pop(item));
+    BOOST_TEST(item == i);
+  }
+  BOOST_TEST(!ring.try_pop(item));
+}
+
+BOOST_AUTO_TEST_CASE(two_threads_in_order)
+{
+  const size_t n_items = 200000;
+  SPSCRing<std::vector<size_t>> ring(2);
+  std::thread producer([&] {
+    for (size_t i = 0; i < n_items; ++i) {
+      std::vector<size_t> item(i % 4, i);
+      while (!ring.try_push(std::move(item)))
+        std::this_thread::yield();
+    }
+  });
+
+  std::vector<size_t> item;
+  size_t n_bad = 0;
+  for (size_t i = 0; i < n_items; ++i) {
+    while (!ring.try_pop(item))
+      std::this_thread::yield();
+    if (item != std::vector<size_t>(i % 4, i))
+      ++n_bad;
+  }
+  producer.join();
+  BOOST_TEST(n_bad == 0u);
+  BOOST_TEST(ring.size() == 0u);
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,141 @@
+/**
+ * @file test_supernova_tc.cxx
+ *
+ * Checks that TriggerCandidateMakerSupernova, which keeps its time window ordered and only
+ * flushes it from the front, gives the same TCs as the original, which searched the whole
+ * window for old activities on every call.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_supernova_tc
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// The original Supernova TC maker, kept as the reference.
+class ReferenceSupernovaTC
+{
+public:
+  void operator()(const TriggerActivity& activity, std::vector<TriggerCandidate>& cand)
+  {
+    timestamp_t time = activity.time_start;
+    flush_old_activity(time);
+    if (activity.inputs.size() > m_hit_threshold)
+      m_activity.push_back(static_cast<TriggerActivity::TriggerActivityData>(activity));
+
+    if (m_activity.size() > m_threshold) {
+      TriggerCandidate tc;
+      tc.time_start = time - 500'000'000;
+      tc.time_end = activity.time_end;
+      tc.time_candidate = time;
+      tc.detid = dunedaq::trgdataformats::WHOLE_DETECTOR;
+      tc.type = TriggerCandidate::Type::kSupernova;
+      tc.algorithm = TriggerCandidate::Algorithm::kSupernova;
+      tc.inputs = m_activity;
+
+      m_activity.clear();
+      cand.push_back(tc);
+    }
+  }
+
+private:
+  void flush_old_activity(timestamp_t time_now)
+  {
+    timestamp_diff_t how_far = time_now - m_time_window;
+    auto end = std::remove_if(m_activity.begin(), m_activity.end(), [how_far](auto& c) -> bool {
+      return (static_cast<timestamp_diff_t>(c.time_start) < how_far);
+    });
+    m_activity.erase(end, m_activity.end());
+  }
+
+  std::vector<TriggerActivity::TriggerActivityData> m_activity;
+  int64_t m_time_window = 500'000'000;
+  uint16_t m_threshold = 3;
+  uint16_t m_hit_threshold = 2;
+};
+
+// Activities a few tenths of the time window apart, with 0 to 5 TPs each.
+std::vector<TriggerActivity>
+make_ta_stream(unsigned seed, size_t n_tas, timestamp_t max_spacing)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<timestamp_t> spacing(0, max_spacing);
+  std::uniform_int_distribution<size_t> n_tps(0, 5);
+  std::vector<TriggerActivity> tas;
+  timestamp_t time = 1'000'000'000;
+  for (size_t i = 0; i < n_tas; ++i) {
+    time += spacing(rng);
+    TriggerActivity ta;
+    ta.time_start = time;
+    ta.time_end = time + 1000;
+    ta.channel_start = static_cast<channel_t>(i % 500);
+    ta.adc_integral = static_cast<uint32_t>(i);
+    for (size_t j = n_tps(rng); j > 0; --j)
+      ta.inputs.push_back(test::make_tp(time, ta.channel_start));
+    tas.push_back(ta);
+  }
+  return tas;
+}
+
+void
+check_against_reference(const std::vector<TriggerActivity>& tas, bool sort_reference_inputs)
+{
+  auto maker = TriggerCandidateFactory::get_instance()->build_maker("TriggerCandidateMakerSupernovaPlugin");
+  BOOST_REQUIRE(maker);
+  ReferenceSupernovaTC reference;
+
+  std::vector<TriggerCandidate> tcs, reference_tcs;
+  for (const auto& ta : tas) {
+    (*maker)(ta, tcs);
+    reference(ta, reference_tcs);
+  }
+
+  // The maker keeps the window in time_start order; the original kept arrival order.
+  if (sort_reference_inputs)
+    for (auto& tc : reference_tcs)
+      std::stable_sort(tc.inputs.begin(), tc.inputs.end(), [](const auto& a, const auto& b) {
+        return a.time_start < b.time_start;
+      });
+
+  BOOST_TEST(reference_tcs.size() > 10u);
+  test::check_same_tcs(tcs, reference_tcs);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_tcs_as_reference)
+{
+  for (unsigned seed = 1; seed <= 4; ++seed)
+    for (timestamp_t max_spacing : { 50'000'000, 200'000'000, 400'000'000 })
+      check_against_reference(make_ta_stream(seed, 5000, max_spacing), false);
+}
+
+// TAs from several TA makers arrive a little out of time order.
+BOOST_AUTO_TEST_CASE(same_tcs_as_reference_out_of_order)
+{
+  for (unsigned seed = 1; seed <= 4; ++seed) {
+    auto tas = make_ta_stream(seed, 5000, 200'000'000);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> shift(0, 3);
+    for (size_t i = 0; i + 1 < tas.size(); ++i)
+      std::swap(tas[i], tas[std::min(tas.size() - 1, i + shift(rng))]);
+    check_against_reference(tas, true);
+  }
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,130 @@
+/**
+ * @file test_ta_store.cxx
+ *
+ * Checks that TAStore overwrites its oldest TAs once full, that with a retention time it grows
+ * instead while they are recent, and that a TC maker's resolve() counts TCs that lost TAs.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_ta_store
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TAStore.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidateFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+TriggerActivity
+make_ta(timestamp_t time, uint64_t adc_integral = 1000)
+{
+  TriggerActivity ta;
+  ta.time_start = time;
+  ta.time_end = time + 10;
+  ta.time_peak = time + 5;
+  ta.channel_start = 10;
+  ta.channel_end = 20;
+  ta.adc_integral = adc_integral;
+  ta.detid = 0;
+  return ta;
+}
+
+// How many TCs from a HorizontalMuon TC maker with its inputs referenced from a store of
+// `store_size` TAs resolve, and how many drops it counts. TAs come `spacing` ticks apart.
+std::pair<size_t, uint64_t>
+run_referencing_maker(size_t store_size, timestamp_t spacing)
+{
+  auto maker = TriggerCandidateFactory::get_instance()->build_maker("TriggerCandidateMakerHorizontalMuonPlugin");
+  BOOST_REQUIRE(maker);
+  maker->configure({ { "trigger_on_adc", true },
+                     { "adc_threshold", 50000 },
+                     { "window_length", 1000 },
+                     { "reference_inputs", true },
+                     { "activity_store_size", store_size } });
+  maker->enable_metrics();
+
+  size_t n_resolved = 0;
+  std::vector<TriggerCandidate> tcs;
+  for (timestamp_t time = 1000; time < 100000; time += spacing) {
+    (*maker)(make_ta(time), tcs);
+    for (auto& tc : tcs) {
+      if (maker->resolve(tc))
+        ++n_resolved;
+      BOOST_TEST(tc.input_refs.empty());
+    }
+    tcs.clear();
+  }
+  return { n_resolved, maker->get_metrics()["drops"].get<uint64_t>() };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fixed_capacity_overwrites_oldest)
+{
+  TAStore store(4);
+  std::vector<ActivityRef> refs;
+  for (timestamp_t time = 100; time <= 600; time += 100)
+    refs.push_back(store.add(make_ta(time)));
+  BOOST_TEST(store.capacity() == 4u);
+  BOOST_TEST(!store.find(refs[0]));
+  BOOST_TEST(!store.find(refs[1]));
+  for (size_t i = 2; i < refs.size(); ++i)
+    BOOST_REQUIRE(store.find(refs[i]) && store.find(refs[i])->time_start == refs[i].time_start);
+}
+
+BOOST_AUTO_TEST_CASE(retention_grows_ring)
+{
+  TAStore store(4);
+  store.set_retention(350);
+  std::vector<ActivityRef> refs;
+  for (timestamp_t time = 100; time <= 2000; time += 100) {
+    refs.push_back(store.add(make_ta(time)));
+    // Every TA less than the retention time older than this one must still be there.
+    for (const auto& ref : refs)
+      if (ref.time_start + 350 > time)
+        BOOST_REQUIRE(store.find(ref) && store.find(ref)->time_start == ref.time_start);
+  }
+  BOOST_TEST(store.capacity() == 4u);
+
+  // A burst of TAs at one time needs more room than that.
+  for (int i = 0; i < 10; ++i)
+    refs.push_back(store.add(make_ta(3000)));
+  BOOST_TEST(store.capacity() == 16u);
+  for (size_t i = refs.size() - 10; i < refs.size(); ++i)
+    BOOST_TEST(store.find(refs[i]));
+  // TAs overwritten before the ring grew stay gone.
+  BOOST_TEST(!store.find(refs[0]));
+  BOOST_TEST(!store.find(refs[refs.size() - 15]));
+}
+
+BOOST_AUTO_TEST_CASE(resolve_counts_lost_tas)
+{
+  TAStore store(2);
+  TriggerCandidate tc;
+  for (timestamp_t time : { 100, 200, 300 })
+    tc.input_refs.push_back(store.add(make_ta(time)));
+  BOOST_TEST(!store.resolve(tc));
+  BOOST_REQUIRE_EQUAL(tc.inputs.size(), 2u);
+  BOOST_TEST(tc.inputs[0].time_start == 200u);
+  BOOST_TEST(tc.input_refs.empty());
+}
+
+// 100 TAs per 1000 tick window don't fit in a store of 8, but it grows to hold them.
+BOOST_AUTO_TEST_CASE(maker_store_holds_a_window)
+{
+  auto [n_resolved, n_drops] = run_referencing_maker(8, 10);
+  BOOST_TEST(n_resolved > 0u);
+  BOOST_TEST(n_drops == 0u);
+}
+
+} // namespace triggeralgs
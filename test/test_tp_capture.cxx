@@ -0,0 +1,181 @@
+/**
+ * @file test_tp_capture.cxx
+ *
+ * Checks that a TP capture reads back exactly what was written, including differences that
+ * go backwards, and that a file the writer never closed, or whose index is corrupt, is read
+ * from its block headers instead.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_tp_capture
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPCapture.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+const uint32_t s_block_size = 100;
+
+std::string
+capture_path()
+{
+  return (std::filesystem::temp_directory_path() / "test_tp_capture.tpc").string();
+}
+
+// TPs whose channel jumps up and down and whose time_peak is sometimes before time_start,
+// with the rarely changing fields changing now and then.
+std::vector<TriggerPrimitive>
+make_awkward_tps(unsigned seed)
+{
+  test::StreamConfig config;
+  config.n_tps = 1050;
+  config.n_detids = 3;
+  auto tps = test::shuffle_locally(test::make_tp_stream(seed, config), 3, seed);
+  std::mt19937 rng(seed);
+  std::bernoulli_distribution rare(0.01);
+  for (auto& tp : tps) {
+    if (rare(rng))
+      tp.time_peak = tp.time_start - 3;
+    if (rare(rng))
+      tp.type = TriggerPrimitive::Type::kPDS;
+    if (rare(rng))
+      tp.flag = 5;
+  }
+  return tps;
+}
+
+void
+write_capture(const std::vector<TriggerPrimitive>& tps, bool close)
+{
+  TPCaptureWriter writer;
+  BOOST_REQUIRE(writer.open(capture_path(), s_block_size));
+  for (const auto& tp : tps)
+    writer.write(tp);
+  if (close)
+    BOOST_REQUIRE(writer.close());
+}
+
+std::string
+read_file()
+{
+  std::ifstream file(capture_path(), std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void
+write_file(const std::string& bytes)
+{
+  std::ofstream file(capture_path(), std::ios::binary | std::ios::trunc);
+  file.write(bytes.data(), bytes.size());
+}
+
+// Reads every block of the capture, which must all be good.
+std::vector<TriggerPrimitive>
+read_capture(TPCaptureReader& reader)
+{
+  std::vector<TriggerPrimitive> tps, block;
+  for (size_t i = 0; i < reader.get_n_blocks(); ++i) {
+    BOOST_REQUIRE(reader.read_block(i, block));
+    tps.insert(tps.end(), block.begin(), block.end());
+  }
+  BOOST_TEST(!reader.read_block(reader.get_n_blocks(), block));
+  return tps;
+}
+
+void
+check_same_tps(const std::vector<TriggerPrimitive>& tps, const std::vector<TriggerPrimitive>& expected, size_t n)
+{
+  BOOST_REQUIRE_EQUAL(tps.size(), n);
+  for (size_t i = 0; i < n; ++i) {
+    test::check_same_tp(tps[i], expected[i]);
+    BOOST_TEST((tps[i].type == expected[i].type));
+    BOOST_TEST(tps[i].flag == expected[i].flag);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+  auto tps = make_awkward_tps(1);
+  write_capture(tps, true);
+
+  TPCaptureReader reader;
+  BOOST_REQUIRE(reader.open(capture_path()));
+  BOOST_TEST(reader.get_n_blocks() == 11u);
+  BOOST_TEST(reader.get_n_tps() == tps.size());
+  check_same_tps(read_capture(reader), tps, tps.size());
+
+  // Every TP at or after a time is in the block find_block() gives, or a later one.
+  timestamp_t time = tps[500].time_start;
+  size_t first = reader.find_block(time);
+  for (size_t i = 0; i < first * s_block_size; ++i)
+    BOOST_TEST(tps[i].time_start < time);
+  std::filesystem::remove(capture_path());
+}
+
+// The writer stopped partway through the file: the complete blocks are still read.
+BOOST_AUTO_TEST_CASE(unclosed_file_recovered)
+{
+  auto tps = make_awkward_tps(2);
+  write_capture(tps, true);
+  TPCaptureReader reader;
+  BOOST_REQUIRE(reader.open(capture_path()));
+  const auto index = reader.get_index();
+  BOOST_REQUIRE(index.size() > 4u);
+
+  // Cut the file off halfway through the fourth block, so there's no index either.
+  std::string bytes = read_file();
+  write_file(bytes.substr(0, index[3].offset + index[3].nbytes / 2));
+  BOOST_REQUIRE(reader.open(capture_path()));
+  BOOST_TEST(reader.get_n_blocks() == 3u);
+  check_same_tps(read_capture(reader), tps, 3 * s_block_size);
+  std::filesystem::remove(capture_path());
+}
+
+// An index entry claiming more bytes than the file holds isn't trusted.
+BOOST_AUTO_TEST_CASE(corrupt_index_rescanned)
+{
+  auto tps = make_awkward_tps(3);
+  write_capture(tps, true);
+  TPCaptureReader reader;
+  BOOST_REQUIRE(reader.open(capture_path()));
+  const size_t n_blocks = reader.get_n_blocks();
+
+  // The index is the block count and then one entry per block, followed by the trailer of
+  // the index offset and magic.
+  std::string bytes = read_file();
+  uint64_t index_offset;
+  std::memcpy(&index_offset, bytes.data() + bytes.size() - 16, sizeof(index_offset));
+  TPCaptureBlockInfo info;
+  char* entry = &bytes[index_offset + sizeof(uint64_t) + 2 * sizeof(TPCaptureBlockInfo)];
+  std::memcpy(&info, entry, sizeof(info));
+  info.nbytes = 0xffffffff;
+  std::memcpy(entry, &info, sizeof(info));
+  write_file(bytes);
+
+  BOOST_REQUIRE(reader.open(capture_path()));
+  BOOST_TEST(reader.get_n_blocks() == n_blocks);
+  BOOST_TEST(reader.get_index()[2].nbytes != 0xffffffffu);
+  check_same_tps(read_capture(reader), tps, tps.size());
+  std::filesystem::remove(capture_path());
+}
+
+} // namespace triggeralgs
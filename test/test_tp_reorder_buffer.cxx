@@ -0,0 +1,173 @@
+/**
+ * @file test_tp_reorder_buffer.cxx
+ *
+ * Checks that TPReorderBuffer, and ReorderingActivityMaker on top of it, put an out-of-order
+ * TP stream back in order, count the TPs too late to place, and hold nothing back longer
+ * than the horizon and one bucket.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_tp_reorder_buffer
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPReorderBuffer.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// `tps` with each TP delayed by up to `max_delay` ticks of arrival time.
+std::vector<TriggerPrimitive>
+delay_randomly(std::vector<TriggerPrimitive> tps, timestamp_t max_delay, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<timestamp_t> delay(0, max_delay);
+  std::vector<std::pair<timestamp_t, size_t>> arrivals;
+  for (size_t i = 0; i < tps.size(); ++i)
+    arrivals.emplace_back(tps[i].time_start + delay(rng), i);
+  std::stable_sort(arrivals.begin(), arrivals.end());
+
+  std::vector<TriggerPrimitive> delayed;
+  for (const auto& arrival : arrivals)
+    delayed.push_back(tps[arrival.second]);
+  return delayed;
+}
+
+bool
+in_time_order(const std::vector<TriggerPrimitive>& tps)
+{
+  return std::is_sorted(tps.begin(), tps.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+}
+
+} // namespace
+
+// Delays within the horizon: everything comes out, in order, and nothing is late.
+BOOST_AUTO_TEST_CASE(within_horizon_restores_order)
+{
+  auto tps = test::make_tp_stream(1);
+  for (timestamp_t bucket_width : { 1, 16, 100 }) {
+    BOOST_TEST_CONTEXT("bucket_width " << bucket_width)
+    {
+      auto input = delay_randomly(tps, 200, bucket_width);
+      BOOST_TEST(!in_time_order(input));
+
+      TPReorderBuffer buffer(200, bucket_width);
+      std::vector<TriggerPrimitive> output;
+      auto sink = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+      for (const auto& tp : input)
+        buffer.add(tp, sink);
+      buffer.flush(sink);
+
+      BOOST_TEST(buffer.get_n_late() == 0u);
+      BOOST_TEST(buffer.size() == 0u);
+      std::vector<TriggerPrimitive> expected = input;
+      std::stable_sort(expected.begin(), expected.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+        return a.time_start < b.time_start;
+      });
+      BOOST_REQUIRE_EQUAL(output.size(), expected.size());
+      for (size_t i = 0; i < output.size(); ++i)
+        test::check_same_tp(output[i], expected[i]);
+    }
+  }
+}
+
+// Delays past the horizon: the output stays in order, and every TP is either released or
+// counted as late. No TP is held once the newest TP is a horizon and a bucket past it.
+BOOST_AUTO_TEST_CASE(beyond_horizon_counts_late)
+{
+  const timestamp_t horizon = 100;
+  const timestamp_t bucket_width = 16;
+  auto input = delay_randomly(test::make_tp_stream(2), 400, 2);
+
+  TPReorderBuffer buffer(horizon, bucket_width);
+  std::vector<TriggerPrimitive> output;
+  std::multiset<timestamp_t> held;
+  auto sink = [&](const TriggerPrimitive& tp) {
+    output.push_back(tp);
+    held.erase(held.find(tp.time_start));
+  };
+
+  timestamp_t newest = 0;
+  size_t n_too_old = 0;
+  for (const auto& tp : input) {
+    uint64_t n_late = buffer.get_n_late();
+    buffer.add(tp, sink);
+    if (buffer.get_n_late() == n_late)
+      held.insert(tp.time_start);
+    newest = std::max(newest, tp.time_start);
+    if (!held.empty() && *held.begin() + horizon + bucket_width <= newest)
+      ++n_too_old;
+  }
+  BOOST_TEST(n_too_old == 0u);
+  BOOST_TEST(buffer.size() == held.size());
+  buffer.flush(sink);
+
+  BOOST_TEST(buffer.get_n_late() > 0u);
+  BOOST_TEST(output.size() + buffer.get_n_late() == input.size());
+  BOOST_TEST(in_time_order(output));
+}
+
+BOOST_AUTO_TEST_CASE(release_until)
+{
+  TPReorderBuffer buffer(1000, 10);
+  std::vector<TriggerPrimitive> output;
+  auto sink = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+  for (timestamp_t time : { 5000, 5030, 5010, 5020 })
+    buffer.add(test::make_tp(time, 1), sink);
+  BOOST_TEST(output.empty());
+
+  buffer.release_until(5020, sink);
+  BOOST_REQUIRE_EQUAL(output.size(), 2u);
+  BOOST_TEST(output[0].time_start == 5000u);
+  BOOST_TEST(output[1].time_start == 5010u);
+  BOOST_TEST(buffer.released_until() == 5020u);
+
+  // Anything before the released time is now late.
+  buffer.add(test::make_tp(5015, 1), sink);
+  BOOST_TEST(buffer.get_n_late() == 1u);
+  buffer.flush(sink);
+  BOOST_TEST(output.size() == 4u);
+}
+
+// The Prescale maker makes a TA per TP, so its TAs show the order the TPs reached it in.
+BOOST_AUTO_TEST_CASE(reordering_maker)
+{
+  auto input = delay_randomly(test::make_tp_stream(3), 400, 3);
+  auto maker = TriggerActivityFactory::get_instance()->build_maker("ReorderingActivityMakerPlugin");
+  BOOST_REQUIRE(maker);
+  maker->configure({ { "maker", "TriggerActivityMakerPrescalePlugin" },
+                     { "maker_config", { { "prescale", 1 } } },
+                     { "horizon", 100 },
+                     { "bucket_width", 16 } });
+  maker->enable_metrics();
+
+  std::vector<TriggerActivity> tas;
+  for (const auto& tp : input)
+    (*maker)(tp, tas);
+  maker->flush(std::numeric_limits<timestamp_t>::max(), tas);
+
+  uint64_t n_drops = maker->get_metrics()["drops"].get<uint64_t>();
+  BOOST_TEST(n_drops > 0u);
+  BOOST_TEST(tas.size() + n_drops == input.size());
+  BOOST_TEST(std::is_sorted(tas.begin(), tas.end(), [](const TriggerActivity& a, const TriggerActivity& b) {
+    return a.time_start < b.time_start;
+  }));
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,164 @@
+/**
+ * @file test_tp_zipper.cxx
+ *
+ * Checks that TPZipper merges per-link TP streams into one time-ordered stream, and that a
+ * lagging link or a full queue costs counted drops rather than order.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE test_tp_zipper
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TPZipper.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include "test_utils.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// A time-ordered stream dealt out round robin to `n_links` links.
+std::vector<std::vector<TriggerPrimitive>>
+make_links(unsigned seed, size_t n_links)
+{
+  std::vector<std::vector<TriggerPrimitive>> links(n_links);
+  auto tps = test::make_tp_stream(seed);
+  for (size_t i = 0; i < tps.size(); ++i)
+    links[i % n_links].push_back(tps[i]);
+  return links;
+}
+
+bool
+in_time_order(const std::vector<TriggerPrimitive>& tps)
+{
+  return std::is_sorted(tps.begin(), tps.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+}
+
+bool
+earlier(const TriggerPrimitive& a, const TriggerPrimitive& b)
+{
+  return std::make_tuple(a.time_start, a.channel, a.adc_integral) < std::make_tuple(b.time_start, b.channel, b.adc_integral);
+}
+
+} // namespace
+
+// Links delivered in random bursts, each in its own order: the output is the merged stream.
+BOOST_AUTO_TEST_CASE(merges_links_in_order)
+{
+  const size_t n_links = 4;
+  auto links = make_links(1, n_links);
+  TPZipper zipper(n_links, std::numeric_limits<timestamp_t>::max());
+  std::vector<TriggerPrimitive> output;
+  auto sink = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<size_t> pick(0, n_links - 1);
+  std::uniform_int_distribution<size_t> burst(1, 20);
+  std::vector<size_t> next(n_links, 0);
+  size_t n_left = 0;
+  for (const auto& link : links)
+    n_left += link.size();
+  while (n_left > 0) {
+    size_t link = pick(rng);
+    for (size_t n = burst(rng); n > 0 && next[link] < links[link].size(); --n, --n_left)
+      zipper.add(link, links[link][next[link]++], sink);
+  }
+  zipper.flush(sink);
+
+  BOOST_TEST(zipper.get_n_late() == 0u);
+  BOOST_TEST(zipper.get_n_forced() == 0u);
+  BOOST_TEST(in_time_order(output));
+
+  std::vector<TriggerPrimitive> expected;
+  for (const auto& link : links)
+    expected.insert(expected.end(), link.begin(), link.end());
+  std::sort(expected.begin(), expected.end(), earlier);
+  std::sort(output.begin(), output.end(), earlier);
+  BOOST_REQUIRE_EQUAL(output.size(), expected.size());
+  for (size_t i = 0; i < output.size(); ++i)
+    test::check_same_tp(output[i], expected[i]);
+}
+
+// A link that stops sending holds the output back until it heartbeats.
+BOOST_AUTO_TEST_CASE(heartbeat_releases)
+{
+  TPZipper zipper(2, 1'000'000);
+  std::vector<TriggerPrimitive> output;
+  auto sink = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+  zipper.add(0, test::make_tp(100, 1), sink);
+  zipper.add(0, test::make_tp(200, 1), sink);
+  BOOST_TEST(output.empty());
+
+  zipper.heartbeat(1, 150, sink);
+  BOOST_REQUIRE_EQUAL(output.size(), 1u);
+  BOOST_TEST(output[0].time_start == 100u);
+  zipper.heartbeat(1, 300, sink);
+  BOOST_TEST(output.size() == 2u);
+}
+
+// One link runs far behind the others: once it is more than max_latency behind it stops
+// holding up the output, and its TPs from before the last emitted time are counted as late.
+BOOST_AUTO_TEST_CASE(lagging_link_counted_late)
+{
+  const size_t n_links = 3;
+  auto links = make_links(2, n_links);
+  TPZipper zipper(n_links, 500);
+  std::vector<TriggerPrimitive> output;
+  auto sink = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+
+  // Link 2 arrives in one go after a third of the other links' TPs.
+  size_t n_early = links[0].size() / 3;
+  for (size_t i = 0; i < links[0].size(); ++i) {
+    zipper.add(0, links[0][i], sink);
+    if (i < links[1].size())
+      zipper.add(1, links[1][i], sink);
+    if (i == n_early) {
+      BOOST_TEST(zipper.is_late(2));
+      for (const auto& tp : links[2])
+        zipper.add(2, tp, sink);
+    }
+  }
+  zipper.flush(sink);
+
+  BOOST_TEST(zipper.get_n_late() > 0u);
+  BOOST_TEST(output.size() + zipper.get_n_late() == links[0].size() + links[1].size() + links[2].size());
+  BOOST_TEST(in_time_order(output));
+}
+
+// A silent link with a small queue on the others: full queues are emitted early, and a TP
+// the silent link sends afterwards from before that is dropped rather than emitted out of order.
+BOOST_AUTO_TEST_CASE(full_queue_forces_output)
+{
+  auto links = make_links(3, 2);
+  TPZipper zipper(3, std::numeric_limits<timestamp_t>::max(), 8);
+  std::vector<TriggerPrimitive> output;
+  auto sink = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+  for (size_t i = 0; i < links[0].size(); ++i) {
+    zipper.add(0, links[0][i], sink);
+    if (i < links[1].size())
+      zipper.add(1, links[1][i], sink);
+    if (i == 100)
+      zipper.add(2, test::make_tp(links[0][10].time_start, 7), sink);
+  }
+  zipper.flush(sink);
+
+  BOOST_TEST(zipper.get_n_forced() > 0u);
+  BOOST_TEST(zipper.get_n_late() == 1u);
+  BOOST_TEST(output.size() == links[0].size() + links[1].size());
+  BOOST_TEST(in_time_order(output));
+}
+
+} // namespace triggeralgs
@@ -0,0 +1,166 @@
+/**
+ * @file test_utils.hpp
+ *
+ * TP streams and TA/TC comparisons shared by the unit tests. Include after
+ * boost/test/included/unit_test.hpp.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_TEST_TEST_UTILS_HPP_
+#define TRIGGERALGS_TEST_TEST_UTILS_HPP_
+
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerActivity.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerCandidate.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/TriggerPrimitive.hpp"
+#include "dunetrigger/triggeralgs/include/triggeralgs/Types.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace triggeralgs {
+namespace test {
+
+inline TriggerPrimitive
+make_tp(timestamp_t time_start, channel_t channel, uint32_t adc_integral = 100, uint16_t detid = 0)
+{
+  TriggerPrimitive tp;
+  tp.type = TriggerPrimitive::Type::kTPC;
+  tp.algorithm = TriggerPrimitive::Algorithm::kSimpleThreshold;
+  tp.time_start = time_start;
+  tp.time_peak = time_start + 5;
+  tp.time_over_threshold = 10;
+  tp.channel = channel;
+  tp.adc_integral = adc_integral;
+  tp.adc_peak = static_cast<uint16_t>(adc_integral / 4);
+  tp.detid = detid;
+  return tp;
+}
+
+/// @brief Settings for make_tp_stream()
+struct StreamConfig
+{
+  size_t n_tps = 20000;
+  timestamp_t mean_spacing = 8; // Mean ticks between consecutive TPs
+  channel_t n_channels = 200;   // Noise TPs are spread over [0, n_channels)
+  double track_fraction = 0.3;  // Chance that a TP starts a run of TPs on nearby channels
+  size_t max_track_length = 24;
+  channel_t max_track_gap = 7;  // Largest channel step within a run, so some runs break up
+  uint32_t max_adc = 400;
+  uint16_t n_detids = 1;
+};
+
+/// @brief A reproducible TP stream in time_start order: noise on random channels mixed with runs
+/// of TPs on nearby channels, as tracks give, including repeated channels and gaps.
+inline std::vector<TriggerPrimitive>
+make_tp_stream(unsigned seed, const StreamConfig& config = StreamConfig())
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<timestamp_t> spacing(0, 2 * config.mean_spacing);
+  std::uniform_int_distribution<channel_t> channel(0, config.n_channels - 1);
+  std::uniform_int_distribution<channel_t> step(0, config.max_track_gap);
+  std::uniform_int_distribution<size_t> length(1, config.max_track_length);
+  std::uniform_int_distribution<uint32_t> adc(1, config.max_adc);
+  std::uniform_int_distribution<uint16_t> detid(0, config.n_detids - 1);
+  std::bernoulli_distribution track(config.track_fraction);
+
+  std::vector<TriggerPrimitive> tps;
+  tps.reserve(config.n_tps);
+  timestamp_t time = 1000;
+  while (tps.size() < config.n_tps) {
+    channel_t ch = channel(rng);
+    uint16_t det = detid(rng);
+    size_t n = track(rng) ? length(rng) : 1;
+    for (size_t i = 0; i < n && tps.size() < config.n_tps; ++i) {
+      time += spacing(rng);
+      tps.push_back(make_tp(time, ch, adc(rng), det));
+      ch += step(rng);
+    }
+  }
+  return tps;
+}
+
+/// @brief `tps` with each TP moved up to `max_shift` ticks out of order, as merged links give.
+inline std::vector<TriggerPrimitive>
+shuffle_locally(std::vector<TriggerPrimitive> tps, size_t max_shift, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> shift(0, max_shift);
+  for (size_t i = 0; i + 1 < tps.size(); ++i)
+    std::swap(tps[i], tps[std::min(tps.size() - 1, i + shift(rng))]);
+  return tps;
+}
+
+inline void
+check_same_tp(const TriggerPrimitive& a, const TriggerPrimitive& b)
+{
+  BOOST_TEST(a.time_start == b.time_start);
+  BOOST_TEST(a.time_peak == b.time_peak);
+  BOOST_TEST(a.time_over_threshold == b.time_over_threshold);
+  BOOST_TEST(a.channel == b.channel);
+  BOOST_TEST(a.adc_integral == b.adc_integral);
+  BOOST_TEST(a.adc_peak == b.adc_peak);
+  BOOST_TEST(a.detid == b.detid);
+}
+
+inline void
+check_same_ta(const TriggerActivity& a, const TriggerActivity& b)
+{
+  BOOST_TEST(a.time_start == b.time_start);
+  BOOST_TEST(a.time_end == b.time_end);
+  BOOST_TEST(a.time_peak == b.time_peak);
+  BOOST_TEST(a.time_activity == b.time_activity);
+  BOOST_TEST(a.channel_start == b.channel_start);
+  BOOST_TEST(a.channel_end == b.channel_end);
+  BOOST_TEST(a.channel_peak == b.channel_peak);
+  BOOST_TEST(a.adc_integral == b.adc_integral);
+  BOOST_TEST(a.adc_peak == b.adc_peak);
+  BOOST_TEST(a.detid == b.detid);
+  BOOST_TEST(static_cast<int>(a.type) == static_cast<int>(b.type));
+  BOOST_TEST(static_cast<int>(a.algorithm) == static_cast<int>(b.algorithm));
+  BOOST_REQUIRE_EQUAL(a.inputs.size(), b.inputs.size());
+  for (size_t i = 0; i < a.inputs.size(); ++i)
+    check_same_tp(a.inputs[i], b.inputs[i]);
+}
+
+inline void
+check_same_tas(const std::vector<TriggerActivity>& a, const std::vector<TriggerActivity>& b)
+{
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); ++i)
+    check_same_ta(a[i], b[i]);
+}
+
+inline void
+check_same_tc(const TriggerCandidate& a, const TriggerCandidate& b)
+{
+  BOOST_TEST(a.time_start == b.time_start);
+  BOOST_TEST(a.time_end == b.time_end);
+  BOOST_TEST(a.time_candidate == b.time_candidate);
+  BOOST_TEST(a.detid == b.detid);
+  BOOST_TEST(static_cast<int>(a.type) == static_cast<int>(b.type));
+  BOOST_TEST(static_cast<int>(a.algorithm) == static_cast<int>(b.algorithm));
+  BOOST_REQUIRE_EQUAL(a.inputs.size(), b.inputs.size());
+  for (size_t i = 0; i < a.inputs.size(); ++i) {
+    BOOST_TEST(a.inputs[i].time_start == b.inputs[i].time_start);
+    BOOST_TEST(a.inputs[i].time_end == b.inputs[i].time_end);
+    BOOST_TEST(a.inputs[i].channel_start == b.inputs[i].channel_start);
+    BOOST_TEST(a.inputs[i].adc_integral == b.inputs[i].adc_integral);
+  }
+}
+
+inline void
+check_same_tcs(const std::vector<TriggerCandidate>& a, const std::vector<TriggerCandidate>& b)
+{
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); ++i)
+    check_same_tc(a[i], b[i]);
+}
+
+} // namespace test
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_TEST_TEST_UTILS_HPP_